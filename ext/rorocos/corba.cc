@@ -10,6 +10,9 @@
 
 #include <rtt/Activity.hpp>
 #include <boost/lexical_cast.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/tss.hpp>
+#include <boost/thread/condition_variable.hpp>
 
 #include "corba.hh"
 #include "rorocos.hh"
@@ -44,19 +47,147 @@ CorbaAccess::CorbaAccess(int argc, char* argv[])
 
 CorbaAccess::~CorbaAccess()
 {
+    // The calls abandoned by corba_cancellable_call and the extension's
+    // background threads use the ORB
+    corba_join_background_threads();
+    // Release the cached references while the ORB is still there
+    m_task_contexts.clear();
     RTT::corba::TaskContextServer::ShutdownOrb(true);
 }
 
+const boost::posix_time::time_duration CorbaAccess::CACHE_VALIDATION_PERIOD =
+    boost::posix_time::seconds(1);
+
 RTaskContext* CorbaAccess::createRTaskContext(std::string const& ior)
 {
-    std::auto_ptr<RTaskContext> new_context( new RTaskContext );
-    // check if ior is a valid IOR if not an exception is thrown
-    new_context->task = getCTaskContext(ior);
-    new_context->main_service = new_context->task->getProvider("this");
-    new_context->ports      = new_context->task->ports();
-    CORBA::String_var nm =  new_context->task->getName();
-    new_context->name = std::string(nm.in());
-    return new_context.release();
+    boost::posix_time::ptime now = boost::posix_time::microsec_clock::universal_time();
+
+    boost::shared_ptr<RTaskContextReferences> references;
+    bool needs_validation = false;
+    {
+        boost::mutex::scoped_lock lock(m_task_contexts_mutex);
+        TaskContextCache::const_iterator it = m_task_contexts.find(ior);
+        if (it != m_task_contexts.end())
+        {
+            references = it->second;
+            needs_validation = (now - references->validated_at > CACHE_VALIDATION_PERIOD);
+        }
+    }
+
+    if (references && needs_validation)
+    {
+        bool alive = false;
+        try { alive = !references->task->_non_existent(); }
+        catch(CORBA::SystemException&) {}
+
+        boost::mutex::scoped_lock lock(m_task_contexts_mutex);
+        if (alive)
+            references->validated_at = now;
+        else
+        {
+            TaskContextCache::iterator it = m_task_contexts.find(ior);
+            if (it != m_task_contexts.end() && it->second == references)
+                m_task_contexts.erase(it);
+            references.reset();
+        }
+    }
+
+    if (!references)
+    {
+        references.reset(new RTaskContextReferences);
+        // check if ior is a valid IOR if not an exception is thrown
+        references->task = getCTaskContext(ior);
+        CORBA::String_var nm = references->task->getName();
+        references->ior = ior;
+        references->name = std::string(nm.in());
+        references->validated_at = now;
+
+        boost::mutex::scoped_lock lock(m_task_contexts_mutex);
+        std::map<std::string, unsigned long>::const_iterator timeout =
+            m_call_timeouts.find(ior);
+        if (timeout != m_call_timeouts.end())
+        {
+            references->call_timeout = timeout->second;
+            omniORB::setClientCallTimeout(references->task.in(), timeout->second);
+        }
+        m_task_contexts[ior] = references;
+    }
+    return new RTaskContext(references);
+}
+
+void CorbaAccess::invalidateRTaskContext(std::string const& ior)
+{
+    boost::mutex::scoped_lock lock(m_task_contexts_mutex);
+    m_task_contexts.erase(ior);
+}
+
+void CorbaAccess::setCallTimeout(std::string const& ior, unsigned long timeout_ms)
+{
+    boost::mutex::scoped_lock lock(m_task_contexts_mutex);
+    if (timeout_ms)
+        m_call_timeouts[ior] = timeout_ms;
+    else
+        m_call_timeouts.erase(ior);
+}
+
+RTaskContext::RTaskContext(boost::shared_ptr<RTaskContextReferences> references)
+    : task(RTT::corba::CTaskContext::_duplicate(references->task))
+    , name(references->name)
+    , references(references) {}
+
+RTT::corba::CService_ptr RTaskContext::mainService()
+{
+    {
+        boost::mutex::scoped_lock lock(references->mutex);
+        if (!CORBA::is_nil(references->main_service))
+            return references->main_service.in();
+    }
+
+    RTT::corba::CService_var service = corba_blocking_fct_call_with_result(
+            boost::bind(&RTT::corba::_objref_CTaskContext::getProvider, task.in(), "this"));
+
+    boost::mutex::scoped_lock lock(references->mutex);
+    if (CORBA::is_nil(references->main_service))
+    {
+        references->main_service = service._retn();
+        if (references->call_timeout)
+            omniORB::setClientCallTimeout(references->main_service.in(), references->call_timeout);
+    }
+    return references->main_service.in();
+}
+
+RTT::corba::CDataFlowInterface_ptr RTaskContext::dataFlow()
+{
+    {
+        boost::mutex::scoped_lock lock(references->mutex);
+        if (!CORBA::is_nil(references->ports))
+            return references->ports.in();
+    }
+
+    RTT::corba::CDataFlowInterface_var ports = corba_blocking_fct_call_with_result(
+            boost::bind(&RTT::corba::_objref_CTaskContext::ports, task.in()));
+
+    boost::mutex::scoped_lock lock(references->mutex);
+    if (CORBA::is_nil(references->ports))
+    {
+        references->ports = ports._retn();
+        if (references->call_timeout)
+            omniORB::setClientCallTimeout(references->ports.in(), references->call_timeout);
+    }
+    return references->ports.in();
+}
+
+void RTaskContext::setCallTimeout(unsigned long timeout_ms)
+{
+    CorbaAccess::instance()->setCallTimeout(references->ior, timeout_ms);
+
+    boost::mutex::scoped_lock lock(references->mutex);
+    references->call_timeout = timeout_ms;
+    omniORB::setClientCallTimeout(references->task.in(), timeout_ms);
+    if (!CORBA::is_nil(references->main_service))
+        omniORB::setClientCallTimeout(references->main_service.in(), timeout_ms);
+    if (!CORBA::is_nil(references->ports))
+        omniORB::setClientCallTimeout(references->ports.in(), timeout_ms);
 }
 
 RTT::corba::CTaskContext_var CorbaAccess::getCTaskContext(std::string const& ior)
@@ -85,12 +216,332 @@ RTT::corba::CTaskContext_var CorbaAccess::getCTaskContext(std::string const& ior
     return mtask;
 }
 
+void CORBACallStatus::run(boost::function<void()> const& call)
+{
+    try { call(); }
+    CORBA_EXCEPTION_HANDLERS
+    EXCEPTION_HANDLERS
+}
+
+void CORBACallStatus::rb_raise(VALUE exception_class)
+{
+    this->exception_class = exception_class;
+    this->exception_message.clear();
+}
+
+void CORBACallStatus::rb_raise(VALUE exception_class, const char* format, ...)
+{
+    char buffer[256];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer,256, format, args);
+    va_end (args);
+
+    this->exception_class = exception_class;
+    this->exception_message = buffer;
+}
+
+void CORBACallStatus::rb_raise(VALUE exception_class, std::string const& message)
+{
+    this->exception_class = exception_class;
+    this->exception_message = message;
+}
+
+namespace
+{
+    /** Per-thread settings of corba_set_thread_call_timeout */
+    struct ThreadCallSettings
+    {
+        unsigned long timeout;
+        bool cancellable;
+    };
+    boost::thread_specific_ptr<ThreadCallSettings> thread_call_settings;
+
+    /** Makes the calling thread an omni_thread until it terminates
+     *
+     * omniORB silently ignores the per-thread call timeouts of the threads
+     * it does not know about, which is the case of the Ruby threads. The
+     * dummy is released by thread_specific_ptr when the thread exits
+     */
+    struct OmniDummyThread
+    {
+        bool created;
+
+        OmniDummyThread()
+            : created(!omni_thread::self())
+        {
+            if (created)
+                omni_thread::create_dummy();
+        }
+        ~OmniDummyThread()
+        {
+            if (created)
+                omni_thread::release_dummy();
+        }
+    };
+    boost::thread_specific_ptr<OmniDummyThread> omni_dummy_thread;
+}
+
+void corba_set_thread_call_timeout(unsigned long timeout_ms, bool cancellable)
+{
+    if (!omni_dummy_thread.get())
+        omni_dummy_thread.reset(new OmniDummyThread);
+    if (!thread_call_settings.get())
+        thread_call_settings.reset(new ThreadCallSettings);
+    thread_call_settings->timeout = timeout_ms;
+    thread_call_settings->cancellable = cancellable;
+    omniORB::setClientThreadCallTimeout(timeout_ms);
+}
+
+unsigned long corba_thread_call_timeout()
+{
+    if (ThreadCallSettings* settings = thread_call_settings.get())
+        return settings->timeout;
+    return 0;
+}
+
+bool corba_thread_calls_cancellable()
+{
+    if (ThreadCallSettings* settings = thread_call_settings.get())
+        return settings->cancellable;
+    return false;
+}
+
+namespace
+{
+    /** Shared state of the helper thread of corba_cancellable_call
+     *
+     * It is owned by both the helper thread and the waiting Ruby thread, so
+     * that it outlives a cancelled wait
+     */
+    struct CORBACancellableCall
+    {
+        boost::function<void()> call;
+        unsigned long timeout;
+        CORBACallStatus status;
+        boost::mutex mutex;
+        boost::condition_variable cond;
+        bool done;
+        bool cancelled;
+
+        CORBACancellableCall(boost::function<void()> const& call, unsigned long timeout)
+            : call(call), timeout(timeout), done(false), cancelled(false) {}
+
+        static void run(boost::shared_ptr<CORBACancellableCall> self)
+        {
+            // Per-thread timeouts are ignored on non-omni threads
+            omni_thread::ensure_self omni_self;
+            if (self->timeout)
+                omniORB::setClientThreadCallTimeout(self->timeout);
+            self->status.run(self->call);
+
+            boost::mutex::scoped_lock lock(self->mutex);
+            self->done = true;
+            self->cond.notify_all();
+        }
+
+        void wait()
+        {
+            boost::mutex::scoped_lock lock(mutex);
+            while (!done && !cancelled)
+                cond.wait(lock);
+        }
+
+        void cancel()
+        {
+            boost::mutex::scoped_lock lock(mutex);
+            cancelled = true;
+            cond.notify_all();
+        }
+    };
+}
+
+namespace
+{
+    /** A thread registered with corba_register_background_thread */
+    struct BackgroundThread
+    {
+        boost::shared_ptr<boost::thread> thread;
+        boost::function<void()> stop;
+    };
+}
+
+// The threads that make CORBA calls in the background, which are stopped and
+// joined by corba_join_background_threads before the ORB gets shut down
+static boost::mutex background_threads_mutex;
+static std::list<BackgroundThread> background_threads;
+
+void corba_register_background_thread(boost::shared_ptr<boost::thread> thread,
+        boost::function<void()> const& stop)
+{
+    boost::mutex::scoped_lock lock(background_threads_mutex);
+    // Forget about the threads that finished in the meantime
+    std::list<BackgroundThread>::iterator it = background_threads.begin();
+    while (it != background_threads.end())
+    {
+        if (it->thread->timed_join(boost::posix_time::seconds(0)))
+            it = background_threads.erase(it);
+        else ++it;
+    }
+    BackgroundThread registered = { thread, stop };
+    background_threads.push_back(registered);
+}
+
+void corba_join_background_threads()
+{
+    std::list<BackgroundThread> threads;
+    {
+        boost::mutex::scoped_lock lock(background_threads_mutex);
+        threads.swap(background_threads);
+    }
+    for (std::list<BackgroundThread>::iterator it = threads.begin();
+            it != threads.end(); ++it)
+    {
+        if (it->stop)
+            it->stop();
+    }
+    for (std::list<BackgroundThread>::iterator it = threads.begin();
+            it != threads.end(); ++it)
+        it->thread->join();
+}
+
+CORBACallStatus corba_cancellable_call(boost::function<void()> const& call)
+{
+    boost::shared_ptr<CORBACancellableCall> state(
+            new CORBACancellableCall(call, corba_thread_call_timeout()));
+    boost::shared_ptr<boost::thread> thread(
+            new boost::thread(boost::bind(&CORBACancellableCall::run, state)));
+    // blocking_fct_call would raise on interrupt, i.e. skip the orphaning of
+    // the thread and leak the shared state. The interrupt is instead
+    // reported through the status, and processed at the next interrupt check
+    non_raising_blocking_fct_call(boost::bind(&CORBACancellableCall::wait, state.get()),
+            boost::bind(&CORBACancellableCall::cancel, state.get()));
+
+    {
+        boost::mutex::scoped_lock lock(state->mutex);
+        if (state->done)
+        {
+            lock.unlock();
+            thread->join();
+            return state->status;
+        }
+    }
+
+    corba_register_background_thread(thread);
+    CORBACallStatus status;
+    status.rb_raise(rb_eInterrupt, "interrupted while waiting for the call to finish");
+    return status;
+}
+
+namespace
+{
+    /** Shared state of the worker threads of corba_blocking_multi_call */
+    struct CORBAMultiCall
+    {
+        std::vector< boost::function<void()> > const& calls;
+        std::vector<CORBACallStatus>& status;
+        boost::mutex mutex;
+        size_t next;
+        bool aborted;
+        /** The thread call timeout of the caller, applied on the workers */
+        unsigned long call_timeout;
+
+        CORBAMultiCall(std::vector< boost::function<void()> > const& calls,
+                std::vector<CORBACallStatus>& status)
+            : calls(calls), status(status), next(0), aborted(false)
+            , call_timeout(corba_thread_call_timeout()) {}
+
+        void thread_worker()
+        {
+            // Per-thread timeouts are ignored on non-omni threads
+            omni_thread::ensure_self omni_self;
+            if (call_timeout)
+                omniORB::setClientThreadCallTimeout(call_timeout);
+            worker();
+        }
+
+        void worker()
+        {
+            while (true)
+            {
+                size_t call_idx;
+                {
+                    boost::mutex::scoped_lock lock(mutex);
+                    if (aborted || next == calls.size())
+                        return;
+                    call_idx = next++;
+                }
+                status[call_idx].run(calls[call_idx]);
+            }
+        }
+
+        void run(size_t max_concurrency)
+        {
+            size_t thread_count = std::min(max_concurrency, calls.size());
+            boost::thread_group threads;
+            try
+            {
+                for (size_t i = 1; i < thread_count; ++i)
+                    threads.create_thread(boost::bind(&CORBAMultiCall::thread_worker, this));
+            }
+            catch(boost::thread_resource_error&)
+            {
+                // Run the calls on the threads that could be created
+            }
+            worker();
+            threads.join_all();
+        }
+
+        void abort()
+        {
+            boost::mutex::scoped_lock lock(mutex);
+            aborted = true;
+        }
+    };
+}
+
+void corba_multi_call(std::vector< boost::function<void()> > const& calls,
+        std::vector<CORBACallStatus>& status, size_t max_concurrency)
+{
+    status.clear();
+    status.resize(calls.size());
+    if (calls.empty())
+        return;
+
+    CORBAMultiCall multi_call(calls, status);
+    multi_call.run(std::max<size_t>(max_concurrency, 1));
+}
+
+void corba_blocking_multi_call(std::vector< boost::function<void()> > const& calls,
+        std::vector<CORBACallStatus>& status, size_t max_concurrency)
+{
+    status.clear();
+    status.resize(calls.size());
+    if (calls.empty())
+        return;
+
+    // blocking_fct_call would raise on interrupt, skipping the reporting of
+    // the calls that did not run as well as the callers' cleanup
+    CORBAMultiCall multi_call(calls, status);
+    non_raising_blocking_fct_call(boost::bind(&CORBAMultiCall::run, &multi_call, std::max<size_t>(max_concurrency, 1)),
+            boost::bind(&CORBAMultiCall::abort, &multi_call));
+
+    for (size_t i = multi_call.next; i < calls.size(); ++i)
+        status[i].rb_raise(rb_eInterrupt, "interrupted before the call could be done");
+}
+
 static VALUE corba_set_call_timeout(VALUE mod, VALUE duration)
 {
     omniORB::setClientCallTimeout(NUM2INT(duration));
     return Qnil;
 }
 
+static VALUE corba_set_thread_call_timeout(VALUE mod, VALUE duration, VALUE cancellable)
+{
+    corba_set_thread_call_timeout(NUM2ULONG(duration), RTEST(cancellable));
+    return Qnil;
+}
+
 static VALUE corba_set_connect_timeout(VALUE mod, VALUE duration)
 {
     omniORB::setClientConnectTimeout(NUM2INT(duration));
@@ -121,8 +572,10 @@ static VALUE corba_init(VALUE mod)
         return Qfalse;
 
     try {
-        char const* argv[2] = { "bla", 0 };
-        CorbaAccess::init(1, const_cast<char**>(argv));
+        // omniORB only honors setClientThreadCallTimeout if per-thread
+        // timeouts are enabled
+        char const* argv[4] = { "bla", "-ORBsupportPerThreadTimeOut", "1", 0 };
+        CorbaAccess::init(3, const_cast<char**>(argv));
         corbaAccess = Data_Wrap_Struct(rb_cObject, 0, corba_deinit, CorbaAccess::instance());
         rb_iv_set(mCORBA, "@corba", corbaAccess);
     } catch(CORBA::Exception& e) {
@@ -223,6 +676,89 @@ static VALUE name_service_task_context_names(VALUE self)
     return result;
 }
 
+/* call-seq:
+ *   do_iors(batch_size, max_concurrency) => { name => ior }
+ *
+ * Returns the IORs of all the tasks registered on the name service. The
+ * names are resolved concurrently
+ */
+static VALUE name_service_iors(VALUE self, VALUE batch_size, VALUE max_concurrency)
+{
+    corba_must_be_initialized();
+
+    NameServiceClient& name_service = get_wrapped<NameServiceClient>(self);
+    std::map<std::string, std::string> iors;
+
+    iors = corba_blocking_fct_call_with_result(boost::bind(&NameServiceClient::getAllIORs,&name_service,NUM2INT(batch_size),NUM2INT(max_concurrency)),
+                              boost::bind(&NameServiceClient::abort,&name_service));
+
+    VALUE result = rb_hash_new();
+    for (map<string, string>::const_iterator it = iors.begin(); it != iors.end(); ++it)
+        rb_hash_aset(result, rb_str_new2(it->first.c_str()), rb_str_new2(it->second.c_str()));
+    return result;
+}
+
+/* call-seq:
+ *   do_enable_cache(ttl, refresh_period, batch_size, max_concurrency)
+ *
+ * Enables the client-side cache of the task names and IORs. The cache is
+ * refreshed with the given batch size and concurrency, see #do_iors
+ */
+static VALUE name_service_enable_cache(VALUE self, VALUE ttl, VALUE refresh_period, VALUE batch_size, VALUE max_concurrency)
+{
+    NameServiceClient& name_service = get_wrapped<NameServiceClient>(self);
+    double ttl_ = NUM2DBL(ttl);
+    double refresh_period_ = NUM2DBL(refresh_period);
+    size_t batch_size_ = NUM2ULONG(batch_size);
+    size_t max_concurrency_ = NUM2ULONG(max_concurrency);
+    if (refresh_period_ <= 0)
+        rb_raise(rb_eArgError, "the refresh period must be strictly positive");
+
+    blocking_fct_call(boost::bind(&NameServiceClient::enableCache,&name_service,
+                ttl_, refresh_period_, batch_size_, max_concurrency_));
+    // The refresh thread uses the ORB, make sure it is stopped before the
+    // ORB gets shut down
+    corba_register_background_thread(name_service.getCacheRefreshThread(),
+            name_service.getCacheRefreshStop());
+    return Qnil;
+}
+
+static VALUE name_service_disable_cache(VALUE self)
+{
+    NameServiceClient& name_service = get_wrapped<NameServiceClient>(self);
+    blocking_fct_call(boost::bind(&NameServiceClient::disableCache,&name_service));
+    return Qnil;
+}
+
+static VALUE name_service_cache_enabled_p(VALUE self)
+{
+    NameServiceClient& name_service = get_wrapped<NameServiceClient>(self);
+    return name_service.isCacheEnabled() ? Qtrue : Qfalse;
+}
+
+/* call-seq:
+ *   do_cache_changes => [added, removed]
+ *
+ * Returns the names that got added and removed since the last call
+ */
+static VALUE name_service_cache_changes(VALUE self)
+{
+    NameServiceClient& name_service = get_wrapped<NameServiceClient>(self);
+    std::vector<std::string> added, removed;
+    name_service.getCacheChanges(added, removed);
+
+    VALUE rb_added = rb_ary_new();
+    for (vector<string>::const_iterator it = added.begin(); it != added.end(); ++it)
+        rb_ary_push(rb_added, rb_str_new2(it->c_str()));
+    VALUE rb_removed = rb_ary_new();
+    for (vector<string>::const_iterator it = removed.begin(); it != removed.end(); ++it)
+        rb_ary_push(rb_removed, rb_str_new2(it->c_str()));
+
+    VALUE result = rb_ary_new();
+    rb_ary_push(result, rb_added);
+    rb_ary_push(result, rb_removed);
+    return result;
+}
 
 static VALUE name_service_unbind(VALUE self,VALUE task_name)
 {
@@ -266,6 +802,18 @@ static VALUE name_service_ior(VALUE self,VALUE task_name)
 }
 
 
+/* call-seq:
+ *   Orocos::CORBA.do_invalidate_task_context(ior)
+ *
+ * Removes the references cached for the task context with the given IOR
+ */
+static VALUE corba_invalidate_task_context(VALUE mod, VALUE ior)
+{
+    if (CorbaAccess::instance())
+        CorbaAccess::instance()->invalidateRTaskContext(StringValuePtr(ior));
+    return Qnil;
+}
+
 void Orocos_init_CORBA()
 {
     VALUE mOrocos = rb_define_module("Orocos");
@@ -273,18 +821,25 @@ void Orocos_init_CORBA()
     rb_define_singleton_method(mCORBA, "do_init", RUBY_METHOD_FUNC(corba_init), 0);
     rb_define_singleton_method(mCORBA, "do_deinit", RUBY_METHOD_FUNC(corba_deinit), 0);
     rb_define_singleton_method(mCORBA, "do_call_timeout", RUBY_METHOD_FUNC(corba_set_call_timeout), 1);
+    rb_define_singleton_method(mCORBA, "do_thread_call_timeout", RUBY_METHOD_FUNC(corba_set_thread_call_timeout), 2);
     rb_define_singleton_method(mCORBA, "do_connect_timeout", RUBY_METHOD_FUNC(corba_set_connect_timeout), 1);
     rb_define_singleton_method(mCORBA, "transportable_type_names", RUBY_METHOD_FUNC(corba_transportable_type_names), 0);
+    rb_define_singleton_method(mCORBA, "do_invalidate_task_context", RUBY_METHOD_FUNC(corba_invalidate_task_context), 1);
 
     VALUE cNameServiceBase = rb_define_class_under(mOrocos, "NameServiceBase",rb_cObject);
     cNameService = rb_define_class_under(mCORBA, "NameService",cNameServiceBase);
     rb_define_singleton_method(cNameService, "new", RUBY_METHOD_FUNC(name_service_create), -1);
     rb_define_method(cNameService, "do_task_context_names", RUBY_METHOD_FUNC(name_service_task_context_names), 0);
     rb_define_method(cNameService, "do_ior", RUBY_METHOD_FUNC(name_service_ior), 1);
+    rb_define_method(cNameService, "do_iors", RUBY_METHOD_FUNC(name_service_iors), 2);
     rb_define_method(cNameService, "do_ip", RUBY_METHOD_FUNC(name_service_ip), 0);
     rb_define_method(cNameService, "do_port", RUBY_METHOD_FUNC(name_service_port), 0);
     rb_define_method(cNameService, "do_validate", RUBY_METHOD_FUNC(name_service_validate), 0);
     rb_define_method(cNameService, "do_reset", RUBY_METHOD_FUNC(name_service_reset), 2);
     rb_define_method(cNameService, "do_unbind", RUBY_METHOD_FUNC(name_service_unbind), 1);
     rb_define_method(cNameService, "do_bind", RUBY_METHOD_FUNC(name_service_bind), 2);
+    rb_define_method(cNameService, "do_enable_cache", RUBY_METHOD_FUNC(name_service_enable_cache), 4);
+    rb_define_method(cNameService, "do_disable_cache", RUBY_METHOD_FUNC(name_service_disable_cache), 0);
+    rb_define_method(cNameService, "cache_enabled?", RUBY_METHOD_FUNC(name_service_cache_enabled_p), 0);
+    rb_define_method(cNameService, "do_cache_changes", RUBY_METHOD_FUNC(name_service_cache_changes), 0);
 }
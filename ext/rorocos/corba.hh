@@ -4,7 +4,13 @@
 #include <omniORB4/CORBA.h>
 
 #include <exception>
+#include <map>
 #include <string>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
 
 #include "StdExceptionC.h"
 #include "TaskContextC.h"
@@ -38,12 +44,67 @@ namespace RTT
     }
 }
 
-struct RTaskContext
+/** The CORBA references of a remote task context
+ *
+ * They are shared by all the RTaskContext objects created for the same IOR
+ * (see CorbaAccess::createRTaskContext). The main service and the data flow
+ * interface are resolved on first use
+ */
+struct RTaskContextReferences
 {
     RTT::corba::CTaskContext_var         task;
     RTT::corba::CService_var     main_service;
     RTT::corba::CDataFlowInterface_var   ports;
+    std::string ior;
+    std::string name;
+    /** The omniORB timeout of the calls on these references, in
+     * milliseconds. Zero if they use the thread or global timeouts
+     */
+    unsigned long call_timeout;
+    /** When the remote task was last known to be reachable. Protected by
+     * CorbaAccess' cache mutex
+     */
+    boost::posix_time::ptime validated_at;
+    boost::mutex mutex;
+
+    RTaskContextReferences()
+        : call_timeout(0) {}
+};
+
+struct RTaskContext
+{
+    RTT::corba::CTaskContext_var         task;
     std::string name;
+
+    RTaskContext(boost::shared_ptr<RTaskContextReferences> references);
+
+    /** Returns the task's main service, resolving it if needed
+     *
+     * It must be called from a Ruby thread, as it raises the Ruby exception
+     * that corresponds to a failed resolution
+     */
+    RTT::corba::CService_ptr mainService();
+
+    /** Returns the task's data flow interface, resolving it if needed
+     *
+     * It must be called from a Ruby thread, as it raises the Ruby exception
+     * that corresponds to a failed resolution
+     */
+    RTT::corba::CDataFlowInterface_ptr dataFlow();
+
+    /** Sets the omniORB timeout of all the calls made on this task, in
+     * milliseconds
+     *
+     * Since the references are shared, it applies to all the RTaskContext
+     * of the same IOR. It is also registered in CorbaAccess, so that it is
+     * applied again when the references get resolved anew. A per-object
+     * timeout has precedence over the thread and global timeouts. Zero
+     * removes it, so that the thread and global timeouts apply again
+     */
+    void setCallTimeout(unsigned long timeout_ms);
+
+private:
+    boost::shared_ptr<RTaskContextReferences> references;
 };
 
 /**
@@ -63,6 +124,15 @@ private:
 
     RTT::corba::CTaskContext_var getCTaskContext(std::string const& ior);
 
+    typedef std::map< std::string, boost::shared_ptr<RTaskContextReferences> > TaskContextCache;
+    TaskContextCache m_task_contexts;
+    /** The timeouts set with RTaskContext::setCallTimeout, per IOR. They are
+     * kept when the cached references get invalidated. Protected by
+     * m_task_contexts_mutex
+     */
+    std::map<std::string, unsigned long> m_call_timeouts;
+    boost::mutex m_task_contexts_mutex;
+
     static CorbaAccess* the_instance;
 
 public:
@@ -70,13 +140,37 @@ public:
     static void deinit();
     static CorbaAccess* instance() { return the_instance; }
 
+    /** How long a cached entry is handed out without checking that the
+     * remote task is still alive
+     */
+    static const boost::posix_time::time_duration CACHE_VALIDATION_PERIOD;
+
     /** Returns a new RTaskContext for the given IOR or throws an exception
      *  if the remote task context cannot be reached.
+     *
+     *  The references are cached per IOR. A cached entry that was not
+     *  validated in the last CACHE_VALIDATION_PERIOD is checked with
+     *  _non_existent() before being handed out, and resolved again if the
+     *  check fails. Within that period, no remote call is made and a dead
+     *  task is only detected by the first call made on it
      */
     RTaskContext* createRTaskContext(std::string const& ior);
+
+    /** Removes the references cached for the given IOR, so that the next
+     * call to createRTaskContext resolves them again
+     */
+    void invalidateRTaskContext(std::string const& ior);
+
+    /** Registers the per-object call timeout of the given IOR, which is then
+     * applied to the references created by createRTaskContext. Zero removes
+     * it
+     */
+    void setCallTimeout(std::string const& ior, unsigned long timeout_ms);
 };
 
+extern VALUE corba_to_ruby(RTypeBinding const& binding, Typelib::Value dest, CORBA::Any& src, TypelibHandlePool* handles = 0);
 extern VALUE corba_to_ruby(std::string const& type_name, Typelib::Value dest, CORBA::Any& src);
+extern CORBA::Any* ruby_to_corba(RTypeBinding const& binding, Typelib::Value src, TypelibHandlePool* handles = 0);
 extern CORBA::Any* ruby_to_corba(std::string const& type_name, Typelib::Value src);
 extern void corba_must_be_initialized();
 
@@ -102,6 +196,139 @@ class InvalidIORError :public std::runtime_error
             std::runtime_error(what_arg) { }
 };
 
+/** Outcome of one of the calls run by corba_blocking_multi_call
+ *
+ * The exception handlers store the Ruby exception that corresponds to a
+ * failed call instead of raising it, so that it can be reported after all the
+ * calls are finished
+ */
+class CORBACallStatus
+{
+public:
+    VALUE exception_class;
+    std::string exception_message;
+
+    CORBACallStatus()
+        : exception_class(Qnil) {}
+
+    bool failed() const { return RTEST(exception_class); }
+    void run(boost::function<void()> const& call);
+
+    void rb_raise(VALUE exception_class);
+    void rb_raise(VALUE exception_class, const char* format, ...);
+    void rb_raise(VALUE exception_class, std::string const& message);
+};
+
+/** Runs +calls+ concurrently with the GVL released
+ *
+ * At most +max_concurrency+ calls are in flight at the same time. If the
+ * Ruby thread gets interrupted, the calls that did not start yet are not
+ * run and are reported as interrupted in +status+. This function does not
+ * raise on interrupt, the interrupt itself being processed at the next
+ * interrupt check
+ *
+ * +status+ is resized to the number of calls. The caller is responsible for
+ * raising the errors it contains
+ */
+extern void corba_blocking_multi_call(std::vector< boost::function<void()> > const& calls,
+        std::vector<CORBACallStatus>& status, size_t max_concurrency = 8);
+
+/** Sets the omniORB timeout of the CORBA calls made from the calling thread,
+ * in milliseconds
+ *
+ * It overrides the global timeout, and is propagated to the worker threads
+ * of corba_blocking_multi_call. Zero removes the override. If +cancellable+
+ * is set, the calls that support it are run with corba_cancellable_call
+ */
+extern void corba_set_thread_call_timeout(unsigned long timeout_ms, bool cancellable = false);
+
+/** Returns the timeout set by corba_set_thread_call_timeout for the calling
+ * thread, or zero if there is none
+ */
+extern unsigned long corba_thread_call_timeout();
+
+/** Whether corba_set_thread_call_timeout required the calls of the calling
+ * thread to be cancellable
+ */
+extern bool corba_thread_calls_cancellable();
+
+/** Runs +call+ on a helper thread and waits for it with the GVL released
+ *
+ * If the Ruby thread gets interrupted while waiting, it stops waiting and
+ * the call is reported as interrupted (with Interrupt) while it finishes in
+ * the background. The interrupt itself is not processed here, but at the
+ * next interrupt check. Such orphaned calls are joined when CORBA gets
+ * deinitialized.
+ * +call+ must therefore own its arguments and the storage of its result, e.g.
+ * by being bound to a boost::shared_ptr
+ *
+ * As for corba_blocking_multi_call, the caller is responsible for raising
+ * the error contained in the returned status
+ */
+extern CORBACallStatus corba_cancellable_call(boost::function<void()> const& call);
+
+/** Registers a thread that makes CORBA calls in the background
+ *
+ * Before the ORB gets shut down, +stop+ (if given) is called to make the
+ * thread terminate, and the thread is joined. +stop+ must therefore not
+ * depend on objects that might be destroyed before that, e.g. by being bound
+ * to a boost::shared_ptr. corba_cancellable_call registers the calls it
+ * abandoned this way
+ */
+extern void corba_register_background_thread(boost::shared_ptr<boost::thread> thread,
+        boost::function<void()> const& stop = boost::function<void()>());
+
+/** Stops and joins the threads registered with
+ * corba_register_background_thread
+ *
+ * It is called before the ORB gets shut down
+ */
+extern void corba_join_background_threads();
+
+namespace
+{
+    template<typename F>
+    struct MultiCallResult
+    {
+        F call;
+        typename F::result_type* result;
+
+        MultiCallResult(F call, typename F::result_type* result)
+            : call(call), result(result) {}
+        void operator()() { *result = call(); }
+    };
+}
+
+/** Runs +calls+ concurrently with the GVL released, and stores their return
+ * values in +results+
+ *
+ * +results+ and +status+ are resized to the number of calls. The result of
+ * a failed call is left default-constructed. Note that F::result_type
+ * cannot be bool, as the elements of std::vector<bool> cannot be written
+ * concurrently
+ */
+template<typename F>
+void corba_blocking_multi_call(std::vector<F> const& calls,
+        std::vector<typename F::result_type>& results,
+        std::vector<CORBACallStatus>& status, size_t max_concurrency = 8)
+{
+    results.clear();
+    results.resize(calls.size());
+
+    std::vector< boost::function<void()> > functions;
+    for (size_t i = 0; i < calls.size(); ++i)
+        functions.push_back(MultiCallResult<F>(calls[i], &results[i]));
+    corba_blocking_multi_call(functions, status, max_concurrency);
+}
+
+/** Runs +calls+ concurrently from a thread that does not hold the GVL
+ *
+ * This is the equivalent of corba_blocking_multi_call for the threads that
+ * are managed by the extension itself, and must not be called from Ruby
+ */
+extern void corba_multi_call(std::vector< boost::function<void()> > const& calls,
+        std::vector<CORBACallStatus>& status, size_t max_concurrency = 8);
+
 template<typename F, typename A=boost::function<void()> >
 class CORBABlockingFunction : public BlockingFunction<F,A>
 {
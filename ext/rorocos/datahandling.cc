@@ -15,84 +15,89 @@ using namespace RTT::corba;
 // +dest+. +dest+ must be holding a memory zone that is valid to hold a value of
 // the given type (i.e. either directly of type type_name, or if type_name is
 // opaque, to the type used to represent this particular opaque)
-VALUE corba_to_ruby(std::string const& type_name, Typelib::Value dest, CORBA::Any& src)
+VALUE corba_to_ruby(RTypeBinding const& binding, Typelib::Value dest, CORBA::Any& src, TypelibHandlePool* handles)
 {
-    // First, get both the CORBA and typelib transports
-    TypeInfo* ti = get_type_info(type_name);
-    RTT::corba::CorbaTypeTransporter* corba_transport = get_corba_transport(ti, false);
+    TypeInfo* ti = binding.type_info;
+    RTT::corba::CorbaTypeTransporter* corba_transport = binding.corba_transport;
     if (! corba_transport)
-        rb_raise(rb_eArgError, "trying to unmarshal %s, but it is not supported by the CORBA transport", type_name.c_str());
-    orogen_transports::TypelibMarshallerBase* typelib_transport = get_typelib_transport(ti, false);
+        rb_raise(rb_eArgError, "trying to unmarshal %s, but it is not supported by the CORBA transport", ti->getTypeName().c_str());
+    orogen_transports::TypelibMarshallerBase* typelib_transport = binding.typelib_transport;
 
     // Fall back to normal typelib behaviour if there is not typelib transport.
     // Do it for plain types as well, as it requires less operations
-    if (!typelib_transport || typelib_transport->isPlainTypelibType())
+    if (binding.plain)
     {
         RTT::base::DataSourceBase::shared_ptr ds =
             ti->buildReference(dest.getData());
         if (!corba_transport->updateFromAny(&src, ds))
-            rb_raise(eCORBA, "failed to unmarshal %s", type_name.c_str());
+            rb_raise(eCORBA, "failed to unmarshal %s", ti->getTypeName().c_str());
     }
     else
     {
-        orogen_transports::TypelibMarshallerBase::Handle* handle = typelib_transport->createHandle();
+        TypelibHandle handle(binding, handles);
         // Set the typelib sample but don't copy it to the orocos sample as we
         // will copy back anyway
-        typelib_transport->setTypelibSample(handle, dest, false);
+        typelib_transport->setTypelibSample(handle.get(), dest, false);
         RTT::base::DataSourceBase::shared_ptr ds =
-            typelib_transport->getDataSource(handle);
+            typelib_transport->getDataSource(handle.get());
         if (!corba_transport->updateFromAny(&src, ds))
-            rb_raise(eCORBA, "failed to unmarshal %s", type_name.c_str());
-        typelib_transport->refreshTypelibSample(handle);
-
-        Typelib::copy(dest, Typelib::Value(typelib_transport->getTypelibSample(handle), dest.getType()));
-        typelib_transport->deleteHandle(handle);
+            rb_raise(eCORBA, "failed to unmarshal %s", ti->getTypeName().c_str());
+        refresh_typelib_value(typelib_transport, handle.get(), dest);
     }
 
     return Qnil;
 }
 
+VALUE corba_to_ruby(std::string const& type_name, Typelib::Value dest, CORBA::Any& src)
+{
+    return corba_to_ruby(get_type_binding(type_name), dest, src);
+}
+
 // Marshals the data that is held by +src+ into a CORBA::Any
-CORBA::Any* ruby_to_corba(std::string const& type_name, Typelib::Value src)
+CORBA::Any* ruby_to_corba(RTypeBinding const& binding, Typelib::Value src, TypelibHandlePool* handles)
 {
-    TypeInfo* ti = get_type_info(type_name);
-    RTT::corba::CorbaTypeTransporter* corba_transport = get_corba_transport(ti, false);
+    TypeInfo* ti = binding.type_info;
+    RTT::corba::CorbaTypeTransporter* corba_transport = binding.corba_transport;
     if (! corba_transport)
-        rb_raise(rb_eArgError, "trying to unmarshal %s, but it is not supported by the CORBA transport", type_name.c_str());
-    orogen_transports::TypelibMarshallerBase* typelib_transport = get_typelib_transport(ti, false);
+        rb_raise(rb_eArgError, "trying to unmarshal %s, but it is not supported by the CORBA transport", ti->getTypeName().c_str());
+    orogen_transports::TypelibMarshallerBase* typelib_transport = binding.typelib_transport;
 
     CORBA::Any* result;
-    if (!typelib_transport || typelib_transport->isPlainTypelibType())
+    if (binding.plain)
     {
         DataSourceBase::shared_ptr data_source = ti->buildReference(src.getData());
         result = corba_transport->createAny(data_source);
         if (! result)
-            rb_raise(eCORBA, "failed to marshal %s", type_name.c_str());
+            rb_raise(eCORBA, "failed to marshal %s", ti->getTypeName().c_str());
     }
     else
     {
-        orogen_transports::TypelibMarshallerBase::Handle* handle = typelib_transport->createHandle();
-        try { typelib_transport->setTypelibSample(handle, src); }
+        TypelibHandle handle(binding, handles);
+        try { typelib_transport->setTypelibSample(handle.get(), src); }
         catch(std::exception& e)
         {
-            rb_raise(eCORBA, "failed to marshal %s: %s", type_name.c_str(), e.what());
+            rb_raise(eCORBA, "failed to marshal %s: %s", ti->getTypeName().c_str(), e.what());
         }
 
         RTT::base::DataSourceBase::shared_ptr ds =
-            typelib_transport->getDataSource(handle);
+            typelib_transport->getDataSource(handle.get());
         result = corba_transport->createAny(ds);
-        typelib_transport->deleteHandle(handle);
     }
 
     return result;
 }
 
+CORBA::Any* ruby_to_corba(std::string const& type_name, Typelib::Value src)
+{
+    return ruby_to_corba(get_type_binding(type_name), src);
+}
+
 static VALUE property_do_read_string(VALUE rbtask, VALUE property_name)
 {
     RTaskContext& task = get_wrapped<RTaskContext>(rbtask);
 
     CORBA::Any_var corba_value = corba_blocking_fct_call_with_result(boost::bind(&_objref_CConfigurationInterface::getProperty,
-                                                                    (_objref_CConfigurationInterface*)task.main_service,
+                                                                    (_objref_CConfigurationInterface*)task.mainService(),
                                                                     StringValuePtr(property_name)));
     char const* result = 0;
     if (!(corba_value >>= result))
@@ -101,18 +106,165 @@ static VALUE property_do_read_string(VALUE rbtask, VALUE property_name)
     return rb_result;
 }
 
-static VALUE property_do_read(VALUE rbtask, VALUE property_name, VALUE type_name, VALUE rb_typelib_value)
+namespace
+{
+    /** A property read run with corba_cancellable_call */
+    struct PropertyQuery
+    {
+        CConfigurationInterface_var config;
+        std::string name;
+        CORBA::Any_var result;
+
+        void run() { result = config->getProperty(name.c_str()); }
+    };
+}
+
+static CORBA::Any* property_cancellable_read(RTaskContext& task, VALUE property_name)
+{
+    CORBA::Any_var result;
+    CORBACallStatus status;
+    {
+        boost::shared_ptr<PropertyQuery> query(new PropertyQuery);
+        query->config = CConfigurationInterface::_duplicate(task.mainService());
+        query->name = StringValuePtr(property_name);
+        status = corba_cancellable_call(boost::bind(&PropertyQuery::run, query));
+        if (!status.failed())
+            result = query->result._retn();
+    }
+    if (status.failed())
+        rb_raise(status.exception_class, "%s", status.exception_message.c_str());
+    return result._retn();
+}
+
+static VALUE property_do_read(VALUE rbtask, VALUE property_name, VALUE type_binding, VALUE rb_typelib_value)
 {
     RTaskContext& task = get_wrapped<RTaskContext>(rbtask);
     Typelib::Value value = typelib_get(rb_typelib_value);
 
-    CORBA::Any_var corba_value = corba_blocking_fct_call_with_result(boost::bind(&_objref_CConfigurationInterface::getProperty,
-                (_objref_CConfigurationInterface*)task.main_service,
-                StringValuePtr(property_name)));
-    corba_to_ruby(StringValuePtr(type_name), value, corba_value);
+    CORBA::Any_var corba_value;
+    if (corba_thread_calls_cancellable())
+        corba_value = property_cancellable_read(task, property_name);
+    else
+        corba_value = corba_blocking_fct_call_with_result(boost::bind(&_objref_CConfigurationInterface::getProperty,
+                    (_objref_CConfigurationInterface*)task.mainService(),
+                    StringValuePtr(property_name)));
+    corba_to_ruby(get_type_binding(type_binding), value, corba_value,
+            get_typelib_handle_pool(type_binding));
     return rb_typelib_value;
 }
 
+static void property_read_into(_objref_CConfigurationInterface* config, std::string const* name, CORBA::Any_var* result)
+{
+    *result = config->getProperty(name->c_str());
+}
+
+// Arguments of property_protected_corba_to_ruby, passed through rb_protect
+struct PropertyReadConversion
+{
+    VALUE type_binding;
+    VALUE rb_value;
+    CORBA::Any* corba_value;
+    VALUE result;
+    VALUE name;
+};
+
+static VALUE property_protected_corba_to_ruby(VALUE _conversion)
+{
+    PropertyReadConversion& conversion =
+        *reinterpret_cast<PropertyReadConversion*>(_conversion);
+    corba_to_ruby(get_type_binding(conversion.type_binding),
+            typelib_get(conversion.rb_value), *conversion.corba_value,
+            get_typelib_handle_pool(conversion.type_binding));
+    rb_hash_aset(conversion.result, conversion.name, conversion.rb_value);
+    return Qnil;
+}
+
+// Validates that +names+ is an array of strings, and returns it as a new array
+// whose elements are guaranteed to be String objects
+static VALUE property_names_to_strings(VALUE names)
+{
+    long count = RARRAY_LEN(names);
+    VALUE result = rb_ary_new2(count);
+    for (long i = 0; i < count; ++i)
+    {
+        VALUE name = rb_ary_entry(names, i);
+        rb_ary_push(result, StringValue(name));
+    }
+    return result;
+}
+
+// Reads the properties listed in +names+ concurrently, and unmarshals them
+// into the corresponding typelib values
+//
+// Returns a hash from the property names to the typelib values. If some of
+// the reads failed, the error of the first one is raised after all reads are
+// finished
+//
+// All the C++ objects live in a block that is closed before any exception is
+// raised, and the unmarshalling is done under rb_protect, so that no
+// destructor gets skipped
+static VALUE property_do_read_all(VALUE rbtask, VALUE names, VALUE type_bindings, VALUE rb_values)
+{
+    RTaskContext& task = get_wrapped<RTaskContext>(rbtask);
+    long count = RARRAY_LEN(names);
+    if (RARRAY_LEN(type_bindings) != count || RARRAY_LEN(rb_values) != count)
+        rb_raise(rb_eArgError, "expected the same number of names, type bindings and values");
+
+    VALUE rb_names = property_names_to_strings(names);
+    _objref_CConfigurationInterface* config =
+        (_objref_CConfigurationInterface*)task.mainService();
+
+    VALUE result = rb_hash_new();
+    VALUE error = Qnil;
+    int jump_state = 0;
+    {
+        std::vector<std::string> property_names;
+        for (long i = 0; i < count; ++i)
+        {
+            VALUE name = rb_ary_entry(rb_names, i);
+            property_names.push_back(std::string(RSTRING_PTR(name), RSTRING_LEN(name)));
+        }
+
+        std::vector<CORBA::Any_var> corba_values(count);
+        std::vector< boost::function<void()> > calls;
+        for (long i = 0; i < count; ++i)
+            calls.push_back(boost::bind(&property_read_into, config,
+                        &property_names[i], &corba_values[i]));
+
+        std::vector<CORBACallStatus> status;
+        corba_blocking_multi_call(calls, status);
+        for (long i = 0; i < count; ++i)
+        {
+            if (status[i].failed())
+            {
+                std::string message = "cannot read property " + property_names[i] + ": " + status[i].exception_message;
+                error = rb_exc_new(status[i].exception_class, message.c_str(), message.size());
+                break;
+            }
+        }
+
+        for (long i = 0; i < count && NIL_P(error) && !jump_state; ++i)
+        {
+            PropertyReadConversion conversion = {
+                rb_ary_entry(type_bindings, i), rb_ary_entry(rb_values, i),
+                &corba_values[i].inout(), result, rb_ary_entry(rb_names, i) };
+            rb_protect(property_protected_corba_to_ruby,
+                    reinterpret_cast<VALUE>(&conversion), &jump_state);
+            if (jump_state)
+            {
+                error = rb_errinfo();
+                rb_set_errinfo(Qnil);
+            }
+        }
+    }
+
+    if (!NIL_P(error))
+        rb_exc_raise(error);
+    else if (jump_state)
+        rb_jump_tag(jump_state);
+    return result;
+}
+
 static VALUE property_do_write_string(VALUE rbtask, VALUE property_name, VALUE rb_value)
 {
     RTaskContext& task = get_wrapped<RTaskContext>(rbtask);
@@ -120,33 +272,138 @@ static VALUE property_do_write_string(VALUE rbtask, VALUE property_name, VALUE r
     CORBA::Any_var corba_value = new CORBA::Any;
     corba_value <<= StringValuePtr(rb_value);
     bool result = corba_blocking_fct_call_with_result(boost::bind(&_objref_CConfigurationInterface::setProperty,
-                (_objref_CConfigurationInterface*)task.main_service,
+                (_objref_CConfigurationInterface*)task.mainService(),
                 StringValuePtr(property_name),corba_value));
     if(!result)
         rb_raise(rb_eArgError, "failed to write the property");
     return Qnil;
 }
 
-static VALUE property_do_write(VALUE rbtask, VALUE property_name, VALUE type_name, VALUE rb_typelib_value)
+static VALUE property_do_write(VALUE rbtask, VALUE property_name, VALUE type_binding, VALUE rb_typelib_value)
 {
     RTaskContext& task = get_wrapped<RTaskContext>(rbtask);
     Typelib::Value value = typelib_get(rb_typelib_value);
 
-    CORBA::Any_var corba_value = ruby_to_corba(StringValuePtr(type_name), value);
+    CORBA::Any_var corba_value = ruby_to_corba(get_type_binding(type_binding), value,
+            get_typelib_handle_pool(type_binding));
     bool result = corba_blocking_fct_call_with_result(boost::bind(&_objref_CConfigurationInterface::setProperty,
-                (_objref_CConfigurationInterface*)task.main_service,
+                (_objref_CConfigurationInterface*)task.mainService(),
                 StringValuePtr(property_name),corba_value));
     if(!result)
         rb_raise(rb_eArgError, "failed to write the property");
     return Qnil;
 }
 
+static void property_write_from(_objref_CConfigurationInterface* config, std::string const* name, CORBA::Any const* value, char* accepted)
+{
+    *accepted = config->setProperty(name->c_str(), *value);
+}
+
+// Arguments of property_protected_ruby_to_corba, passed through rb_protect
+struct PropertyWriteConversion
+{
+    VALUE type_binding;
+    VALUE rb_value;
+    CORBA::Any* corba_value;
+};
+
+static VALUE property_protected_ruby_to_corba(VALUE _conversion)
+{
+    PropertyWriteConversion& conversion =
+        *reinterpret_cast<PropertyWriteConversion*>(_conversion);
+    conversion.corba_value = ruby_to_corba(get_type_binding(conversion.type_binding),
+            typelib_get(conversion.rb_value),
+            get_typelib_handle_pool(conversion.type_binding));
+    return Qnil;
+}
+
+// Writes the properties listed in +names+ concurrently
+//
+// All values are marshalled before the first write is issued. Returns a hash
+// from the names of the properties that could not be written to the
+// corresponding exception, which is empty if all writes succeeded
+//
+// As in property_do_read_all, the C++ objects are scoped so that an exception
+// raised while marshalling is re-raised only once they are destroyed
+static VALUE property_do_write_all(VALUE rbtask, VALUE names, VALUE type_bindings, VALUE rb_values)
+{
+    RTaskContext& task = get_wrapped<RTaskContext>(rbtask);
+    long count = RARRAY_LEN(names);
+    if (RARRAY_LEN(type_bindings) != count || RARRAY_LEN(rb_values) != count)
+        rb_raise(rb_eArgError, "expected the same number of names, type bindings and values");
+
+    VALUE rb_names = property_names_to_strings(names);
+    _objref_CConfigurationInterface* config =
+        (_objref_CConfigurationInterface*)task.mainService();
+
+    VALUE result = rb_hash_new();
+    VALUE error = Qnil;
+    int jump_state = 0;
+    {
+        std::vector<std::string> property_names;
+        std::vector<CORBA::Any_var> corba_values(count);
+        for (long i = 0; i < count; ++i)
+        {
+            VALUE name = rb_ary_entry(rb_names, i);
+            property_names.push_back(std::string(RSTRING_PTR(name), RSTRING_LEN(name)));
+
+            PropertyWriteConversion conversion = {
+                rb_ary_entry(type_bindings, i), rb_ary_entry(rb_values, i), 0 };
+            rb_protect(property_protected_ruby_to_corba,
+                    reinterpret_cast<VALUE>(&conversion), &jump_state);
+            if (jump_state)
+            {
+                error = rb_errinfo();
+                rb_set_errinfo(Qnil);
+                break;
+            }
+            corba_values[i] = conversion.corba_value;
+        }
+
+        if (!jump_state)
+        {
+            // char and not bool, as the elements are written concurrently
+            std::vector<char> accepted(count, false);
+            std::vector< boost::function<void()> > calls;
+            for (long i = 0; i < count; ++i)
+                calls.push_back(boost::bind(&property_write_from, config,
+                            &property_names[i], &corba_values[i].in(), &accepted[i]));
+
+            std::vector<CORBACallStatus> status;
+            corba_blocking_multi_call(calls, status);
+            for (long i = 0; i < count; ++i)
+            {
+                if (!status[i].failed() && !accepted[i])
+                    status[i].rb_raise(rb_eArgError, "the remote task refused the new value");
+            }
+
+            for (long i = 0; i < count; ++i)
+            {
+                if (!status[i].failed())
+                    continue;
+
+                std::string message = "failed to write property " + property_names[i];
+                if (!status[i].exception_message.empty())
+                    message += ": " + status[i].exception_message;
+                rb_hash_aset(result, rb_ary_entry(rb_names, i),
+                        rb_exc_new(status[i].exception_class, message.c_str(), message.size()));
+            }
+        }
+    }
+
+    if (!NIL_P(error))
+        rb_exc_raise(error);
+    else if (jump_state)
+        rb_jump_tag(jump_state);
+    return result;
+}
+
 static VALUE attribute_do_read_string(VALUE rbtask, VALUE property_name)
 {
     RTaskContext& task = get_wrapped<RTaskContext>(rbtask);
 
     CORBA::Any_var corba_value = corba_blocking_fct_call_with_result(boost::bind(&_objref_CConfigurationInterface::getAttribute,
-                                                                    (_objref_CConfigurationInterface*)task.main_service,
+                                                                    (_objref_CConfigurationInterface*)task.mainService(),
                                                                     StringValuePtr(property_name)));
     char const* result = 0;
     if (!(corba_value >>= result))
@@ -155,15 +412,16 @@ static VALUE attribute_do_read_string(VALUE rbtask, VALUE property_name)
     return rb_result;
 }
 
-static VALUE attribute_do_read(VALUE rbtask, VALUE property_name, VALUE type_name, VALUE rb_typelib_value)
+static VALUE attribute_do_read(VALUE rbtask, VALUE property_name, VALUE type_binding, VALUE rb_typelib_value)
 {
     RTaskContext& task = get_wrapped<RTaskContext>(rbtask);
     Typelib::Value value = typelib_get(rb_typelib_value);
 
     CORBA::Any_var corba_value = corba_blocking_fct_call_with_result(boost::bind(&_objref_CConfigurationInterface::getAttribute,
-                (_objref_CConfigurationInterface*)task.main_service,
+                (_objref_CConfigurationInterface*)task.mainService(),
                 StringValuePtr(property_name)));
-    corba_to_ruby(StringValuePtr(type_name), value, corba_value);
+    corba_to_ruby(get_type_binding(type_binding), value, corba_value,
+            get_typelib_handle_pool(type_binding));
     return rb_typelib_value;
 }
 
@@ -174,21 +432,22 @@ static VALUE attribute_do_write_string(VALUE rbtask, VALUE property_name, VALUE
     CORBA::Any_var corba_value = new CORBA::Any;
     corba_value <<= StringValuePtr(rb_value);
     bool result = corba_blocking_fct_call_with_result(boost::bind(&_objref_CConfigurationInterface::setAttribute,
-                (_objref_CConfigurationInterface*)task.main_service,
+                (_objref_CConfigurationInterface*)task.mainService(),
                 StringValuePtr(property_name),corba_value));
     if(!result)
         rb_raise(rb_eArgError, "failed to write the attribute");
     return Qnil;
 }
 
-static VALUE attribute_do_write(VALUE rbtask, VALUE property_name, VALUE type_name, VALUE rb_typelib_value)
+static VALUE attribute_do_write(VALUE rbtask, VALUE property_name, VALUE type_binding, VALUE rb_typelib_value)
 {
     RTaskContext& task = get_wrapped<RTaskContext>(rbtask);
     Typelib::Value value = typelib_get(rb_typelib_value);
 
-    CORBA::Any_var corba_value = ruby_to_corba(StringValuePtr(type_name), value);
+    CORBA::Any_var corba_value = ruby_to_corba(get_type_binding(type_binding), value,
+            get_typelib_handle_pool(type_binding));
     bool result = corba_blocking_fct_call_with_result(boost::bind(&_objref_CConfigurationInterface::setAttribute,
-                (_objref_CConfigurationInterface*)task.main_service,
+                (_objref_CConfigurationInterface*)task.mainService(),
                 StringValuePtr(property_name),corba_value));
     if(!result)
         rb_raise(rb_eArgError, "failed to write the attribute");
@@ -201,6 +460,8 @@ void Orocos_init_data_handling(VALUE cTaskContext)
     rb_define_method(cTaskContext, "do_property_write_string",  RUBY_METHOD_FUNC(property_do_write_string),  2);
     rb_define_method(cTaskContext, "do_property_read",          RUBY_METHOD_FUNC(property_do_read),          3);
     rb_define_method(cTaskContext, "do_property_write",         RUBY_METHOD_FUNC(property_do_write),         3);
+    rb_define_method(cTaskContext, "do_property_read_all",      RUBY_METHOD_FUNC(property_do_read_all),      3);
+    rb_define_method(cTaskContext, "do_property_write_all",     RUBY_METHOD_FUNC(property_do_write_all),     3);
     rb_define_method(cTaskContext, "do_attribute_read_string",  RUBY_METHOD_FUNC(attribute_do_read_string),  1);
     rb_define_method(cTaskContext, "do_attribute_write_string", RUBY_METHOD_FUNC(attribute_do_write_string), 2);
     rb_define_method(cTaskContext, "do_attribute_read",         RUBY_METHOD_FUNC(attribute_do_read),         3);
@@ -7,13 +7,17 @@
 namespace CORBA {
     class Any;
 }
+struct RTypeBinding;
+class TypelibHandlePool;
 
 // Unmarshals the data that is included in the given any into the memory held in
 // +dest+. +dest+ must be holding a memory zone that is valid to hold a value of
 // the given type.
+VALUE corba_to_ruby(RTypeBinding const& binding, Typelib::Value dest, CORBA::Any& src, TypelibHandlePool* handles = 0);
 VALUE corba_to_ruby(std::string const& type_name, Typelib::Value dest, CORBA::Any& src);
 
 // Marshals the data that is held by +src+ into a CORBA::Any
+CORBA::Any* ruby_to_corba(RTypeBinding const& binding, Typelib::Value src, TypelibHandlePool* handles = 0);
 CORBA::Any* ruby_to_corba(std::string const& type_name, Typelib::Value src);
 
 #endif
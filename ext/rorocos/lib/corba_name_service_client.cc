@@ -6,25 +6,80 @@
 #define TOPIC "TaskContexts"    
 
 #include "corba_name_service_client.hh"
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
 using namespace corba;
 
+// State shared by the threads started by getAllIORs
+struct NameServiceClient::IORResolution
+{
+    std::vector<std::string> names;
+    std::vector<std::string> iors;
+    size_t next;
+    std::auto_ptr<CORBA::Exception> error;
+    boost::mutex mutex;
+};
+
+// State shared by a NameServiceClient and the thread that refreshes its cache
+//
+// The thread fetches the IORs through its own client, so that it does not
+// share the abort flag of the calls made on the owner. It updates the owner's
+// cache only while holding the mutex, and stops once the owner got reset to
+// null by stopCacheRefresh
+struct NameServiceClient::CacheRefresh
+{
+    NameServiceClient fetcher;
+    boost::posix_time::time_duration period;
+    size_t batch_size;
+    size_t max_concurrency;
+    boost::mutex mutex;
+    boost::condition_variable cond;
+    NameServiceClient* owner;
+
+    CacheRefresh(NameServiceClient* owner, std::string const& ip, std::string const& port,
+            boost::posix_time::time_duration period, size_t batch_size, size_t max_concurrency)
+        : fetcher(ip, port), period(period)
+        , batch_size(batch_size), max_concurrency(max_concurrency)
+        , owner(owner) {}
+};
+
 NameServiceClient::NameServiceClient(std::string name_service_ip,std::string name_service_port):
     name_service_port(name_service_port),
     name_service_ip(name_service_ip),
-    abort_flag(false)
+    abort_flag(false),
+    cache_enabled(false)
 {
 }
 
 NameServiceClient::~NameServiceClient()
 {
+    disableCache();
 }
 
 void NameServiceClient::reset(std::string const &ip,std::string const &port)
 {
-    boost::mutex::scoped_lock lock(mut);
-    root_context = CosNaming::NamingContext::_nil();
-    name_service_ip = ip;
-    name_service_port = port;
+    {
+        boost::mutex::scoped_lock lock(mut);
+        root_context = CosNaming::NamingContext::_nil();
+        name_service_ip = ip;
+        name_service_port = port;
+    }
+
+    // the cached names belong to the previous name service
+    boost::shared_ptr<CacheRefresh> refresh;
+    {
+        boost::mutex::scoped_lock lock(cache_mutex);
+        cache.clear();
+        cache_added.clear();
+        cache_removed.clear();
+        cache_time = boost::posix_time::ptime();
+        refresh = cache_refresh;
+    }
+    if (refresh)
+        refresh->fetcher.reset(ip, port);
 }
 
 CosNaming::NamingContext_var NameServiceClient::getNameService()
@@ -53,10 +108,25 @@ void NameServiceClient::abort()
     abort_flag = true;
 }
 
-std::vector<std::string> NameServiceClient::getTaskContextNames()
+std::vector<std::string> NameServiceClient::getTaskContextNames(size_t batch_size)
 {
-    // no need to lock mutex getNameService is taking care of this.
+    {
+        boost::mutex::scoped_lock lock(cache_mutex);
+        if (isCacheFresh())
+        {
+            std::vector<std::string> task_names;
+            for (std::map<std::string,std::string>::const_iterator it = cache.begin(); it != cache.end(); ++it)
+                task_names.push_back(it->first);
+            return task_names;
+        }
+    }
     abort_flag = false;
+    return listTaskContextNames(batch_size);
+}
+
+std::vector<std::string> NameServiceClient::listTaskContextNames(size_t batch_size)
+{
+    // no need to lock mutex getNameService is taking care of this.
     CosNaming::Name server_name;
     server_name.length(1);
     server_name[0].id = CORBA::string_dup(TOPIC);
@@ -74,20 +144,87 @@ std::vector<std::string> NameServiceClient::getTaskContextNames()
     if(abort_flag)
         return task_names;
 
-    control_tasks->list(0, binding_list, binding_it);
+    // the first batch is returned by list itself, the others through the
+    // iterator
+    control_tasks->list(batch_size, binding_list, binding_it);
+    for (unsigned int i = 0; i < binding_list->length(); ++i)
+        task_names.push_back(std::string(binding_list[i].binding_name[0].id.in()));
     if (CORBA::is_nil(binding_it))
         return task_names;
 
     // iterate over all task names
-    while(!abort_flag && binding_it->next_n(10, binding_list))
+    while(!abort_flag && binding_it->next_n(batch_size, binding_list))
     {
         CosNaming::BindingList list = binding_list.in();
         for (unsigned int i = 0; i < list.length(); ++i)
             task_names.push_back(std::string(list[i].binding_name[0].id.in()));
     }
+    binding_it->destroy();
     return task_names;
 }
 
+std::map<std::string,std::string> NameServiceClient::getAllIORs(size_t batch_size, size_t max_concurrency)
+{
+    {
+        boost::mutex::scoped_lock lock(cache_mutex);
+        if (isCacheFresh())
+            return cache;
+    }
+    abort_flag = false;
+    return fetchAllIORs(batch_size, max_concurrency);
+}
+
+std::map<std::string,std::string> NameServiceClient::fetchAllIORs(size_t batch_size, size_t max_concurrency)
+{
+    IORResolution resolution;
+    resolution.names = listTaskContextNames(batch_size);
+    resolution.iors.resize(resolution.names.size());
+    resolution.next = 0;
+
+    boost::thread_group workers;
+    size_t worker_count = std::min(std::max<size_t>(max_concurrency, 1), resolution.names.size());
+    for (size_t i = 0; i < worker_count; ++i)
+        workers.create_thread(boost::bind(&NameServiceClient::resolveIORs, this, &resolution));
+    workers.join_all();
+
+    if (resolution.error.get())
+        resolution.error->_raise();
+
+    std::map<std::string,std::string> result;
+    for (size_t i = 0; i < resolution.names.size(); ++i)
+    {
+        if (!resolution.iors[i].empty())
+            result[resolution.names[i]] = resolution.iors[i];
+    }
+    return result;
+}
+
+void NameServiceClient::resolveIORs(IORResolution* resolution)
+{
+    while (!abort_flag)
+    {
+        size_t index;
+        {
+            boost::mutex::scoped_lock lock(resolution->mutex);
+            if (resolution->error.get() || resolution->next == resolution->names.size())
+                return;
+            index = resolution->next++;
+        }
+
+        try { resolution->iors[index] = resolveIOR(resolution->names[index]); }
+        catch(CosNaming::NamingContext::NotFound&)
+        {
+            // the task got unbound since the names have been listed
+        }
+        catch(CORBA::Exception& e)
+        {
+            boost::mutex::scoped_lock lock(resolution->mutex);
+            if (!resolution->error.get())
+                resolution->error.reset(e._NP_duplicate());
+        }
+    }
+}
+
 void NameServiceClient::bind(CORBA::Object_var const &obj,std::string const& name)
 {
     // no need to lock mutex getNameService is taking care of this.
@@ -108,6 +245,9 @@ void NameServiceClient::bind(CORBA::Object_var const &obj,std::string const& nam
     n[0].id = CORBA::string_dup(TOPIC);
     n[1].id = CORBA::string_dup(name.c_str());
     root_context->rebind(n, obj);
+
+    CORBA::String_var ior = RTT::corba::ApplicationServer::orb->object_to_string(obj);
+    cacheAdd(name, std::string(ior.in()));
 }
 
 void NameServiceClient::validate()
@@ -127,6 +267,7 @@ bool NameServiceClient::unbind(std::string const& name)
         server_name[0].id = CORBA::string_dup( TOPIC );
         server_name[1].id = CORBA::string_dup( name.c_str() );
         root_context->unbind(server_name);
+        cacheRemove(name);
         return true;
     }
     catch(CosNaming::NamingContext::NotFound) {}
@@ -134,6 +275,20 @@ bool NameServiceClient::unbind(std::string const& name)
 }
 
 std::string NameServiceClient::getIOR(std::string const& name)
+{
+    {
+        boost::mutex::scoped_lock lock(cache_mutex);
+        if (isCacheFresh())
+        {
+            std::map<std::string,std::string>::const_iterator it = cache.find(name);
+            if (it != cache.end())
+                return it->second;
+        }
+    }
+    return resolveIOR(name);
+}
+
+std::string NameServiceClient::resolveIOR(std::string const& name)
 {
     // no need to lock mutex getNameService is taking care of this.
     CosNaming::NamingContext_var root_context = getNameService();
@@ -147,6 +302,179 @@ std::string NameServiceClient::getIOR(std::string const& name)
     return std::string(s.in());
 }
 
+void NameServiceClient::enableCache(double ttl, double refresh_period,
+        size_t batch_size, size_t max_concurrency)
+{
+    if (refresh_period <= 0)
+        throw std::invalid_argument("the refresh period of the name service cache must be strictly positive");
+
+    disableCache();
+
+    boost::shared_ptr<CacheRefresh> refresh(new CacheRefresh(this, getIp(), getPort(),
+                boost::posix_time::microseconds(static_cast<long>(refresh_period * 1e6)),
+                batch_size, max_concurrency));
+    boost::shared_ptr<boost::thread> thread(
+            new boost::thread(boost::bind(&NameServiceClient::refreshCache, refresh)));
+
+    boost::mutex::scoped_lock lock(cache_mutex);
+    cache_ttl = boost::posix_time::microseconds(static_cast<long>(ttl * 1e6));
+    cache_enabled = true;
+    cache_refresh = refresh;
+    cache_thread = thread;
+}
+
+void NameServiceClient::disableCache()
+{
+    boost::shared_ptr<CacheRefresh> refresh;
+    {
+        boost::mutex::scoped_lock lock(cache_mutex);
+        if (!cache_enabled)
+            return;
+        cache_enabled = false;
+        refresh.swap(cache_refresh);
+        cache_thread.reset();
+    }
+
+    // Do not wait for the thread, as it might be in the middle of a call to
+    // the name service. It only has to stop updating this object
+    stopCacheRefresh(refresh);
+
+    boost::mutex::scoped_lock lock(cache_mutex);
+    cache.clear();
+    cache_added.clear();
+    cache_removed.clear();
+    cache_time = boost::posix_time::ptime();
+}
+
+void NameServiceClient::stopCacheRefresh(boost::shared_ptr<CacheRefresh> refresh)
+{
+    {
+        boost::mutex::scoped_lock lock(refresh->mutex);
+        refresh->owner = 0;
+    }
+    refresh->cond.notify_all();
+    refresh->fetcher.abort();
+}
+
+boost::shared_ptr<boost::thread> NameServiceClient::getCacheRefreshThread()
+{
+    boost::mutex::scoped_lock lock(cache_mutex);
+    return cache_thread;
+}
+
+boost::function<void()> NameServiceClient::getCacheRefreshStop()
+{
+    boost::mutex::scoped_lock lock(cache_mutex);
+    if (!cache_refresh)
+        return boost::function<void()>();
+    return boost::bind(&NameServiceClient::stopCacheRefresh, cache_refresh);
+}
+
+bool NameServiceClient::isCacheEnabled()
+{
+    boost::mutex::scoped_lock lock(cache_mutex);
+    return cache_enabled;
+}
+
+void NameServiceClient::getCacheChanges(std::vector<std::string>& added, std::vector<std::string>& removed)
+{
+    boost::mutex::scoped_lock lock(cache_mutex);
+    added.swap(cache_added);
+    removed.swap(cache_removed);
+    cache_added.clear();
+    cache_removed.clear();
+}
+
+bool NameServiceClient::isCacheFresh() const
+{
+    if (!cache_enabled || cache_time.is_not_a_date_time())
+        return false;
+    return boost::posix_time::microsec_clock::universal_time() - cache_time < cache_ttl;
+}
+
+void NameServiceClient::updateCache(std::map<std::string,std::string> const& iors)
+{
+    boost::mutex::scoped_lock lock(cache_mutex);
+    for (std::map<std::string,std::string>::const_iterator it = cache.begin(); it != cache.end(); ++it)
+    {
+        if (iors.find(it->first) == iors.end())
+            cache_removed.push_back(it->first);
+    }
+    for (std::map<std::string,std::string>::const_iterator it = iors.begin(); it != iors.end(); ++it)
+    {
+        std::map<std::string,std::string>::const_iterator cached = cache.find(it->first);
+        if (cached == cache.end())
+            cache_added.push_back(it->first);
+        else if (cached->second != it->second)
+        {
+            // the task got registered again, most likely by a new process
+            cache_removed.push_back(it->first);
+            cache_added.push_back(it->first);
+        }
+    }
+    cache = iors;
+    cache_time = boost::posix_time::microsec_clock::universal_time();
+}
+
+void NameServiceClient::cacheAdd(std::string const& name, std::string const& ior)
+{
+    boost::mutex::scoped_lock lock(cache_mutex);
+    if (!cache_enabled)
+        return;
+    std::map<std::string,std::string>::iterator it = cache.find(name);
+    if (it == cache.end())
+        cache_added.push_back(name);
+    else if (it->second != ior)
+    {
+        cache_removed.push_back(name);
+        cache_added.push_back(name);
+    }
+    cache[name] = ior;
+}
+
+void NameServiceClient::cacheRemove(std::string const& name)
+{
+    boost::mutex::scoped_lock lock(cache_mutex);
+    if (cache.erase(name))
+        cache_removed.push_back(name);
+}
+
+void NameServiceClient::refreshCache(boost::shared_ptr<CacheRefresh> refresh)
+{
+    while (true)
+    {
+        std::map<std::string,std::string> iors;
+        bool fetched = false;
+        try
+        {
+            iors = refresh->fetcher.fetchAllIORs(refresh->batch_size, refresh->max_concurrency);
+            fetched = true;
+        }
+        catch(CORBA::Exception&)
+        {
+            // keep the current cache. It will be ignored once it is older
+            // than the TTL, and the errors will then be reported by the
+            // calls that go to the name service
+        }
+        catch(std::exception&) { }
+
+        boost::mutex::scoped_lock lock(refresh->mutex);
+        if (!refresh->owner)
+            break;
+        if (fetched)
+            refresh->owner->updateCache(iors);
+        refresh->cond.timed_wait(lock, refresh->period);
+        if (!refresh->owner)
+            break;
+    }
+
+    // The refresh state might outlive the ORB, e.g. if the owner gets
+    // destroyed after it got shut down. Release the fetcher's reference to
+    // the name service while the ORB is still there
+    boost::mutex::scoped_lock lock(refresh->fetcher.mut);
+    refresh->fetcher.root_context = CosNaming::NamingContext::_nil();
+}
+
 //returns a valid context or throws an exception
 CosNaming::NamingContext_var NameServiceClient::getNameService(const std::string name_service_ip, const std::string name_service_port)
 {
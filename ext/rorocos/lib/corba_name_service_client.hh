@@ -11,11 +11,18 @@
 #ifndef __CORBA_NAME_SERVICE_CLIENT_HPP__
 #define __CORBA_NAME_SERVICE_CLIENT_HPP__
 
+#include <map>
 #include <vector>
 #include <string>
 #include "TaskContextC.h"
 #include <rtt/transports/corba/TaskContextProxy.hpp>
 #include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/function.hpp>
+#include <boost/atomic.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
 
 namespace corba
 {
@@ -40,7 +47,16 @@ namespace corba
             ~NameServiceClient();
             
             // returns all available task names which are bound to the name service
-            std::vector<std::string> getTaskContextNames();
+            //
+            // the names are fetched from the name service batch_size at a time
+            std::vector<std::string> getTaskContextNames(size_t batch_size = 10);
+
+            // returns the IORs of all the tasks which are bound to the name service
+            //
+            // the names are fetched batch_size at a time, and then resolved
+            // by up to max_concurrency threads. Names that are unbound while
+            // being resolved are not part of the result
+            std::map<std::string,std::string> getAllIORs(size_t batch_size = 100, size_t max_concurrency = 8);
 
             // returns the port number of the used name service 
             std::string getPort();
@@ -67,7 +83,66 @@ namespace corba
             // abort is trying to canceling the call
             void abort();
 
+            // enables the client-side cache of the task names and IORs
+            //
+            // a background thread fetches all IORs every refresh_period
+            // seconds, through its own connection to the name service, with
+            // the given batch_size and max_concurrency (see getAllIORs).
+            // getTaskContextNames, getAllIORs and getIOR are then answered
+            // from memory as long as the last successful refresh is not older
+            // than ttl seconds. getIOR still asks the name service for names
+            // that are not in the cache
+            //
+            // refresh_period must be strictly positive
+            void enableCache(double ttl, double refresh_period,
+                    size_t batch_size = 100, size_t max_concurrency = 8);
+
+            // stops the background thread and clears the cache
+            //
+            // the thread is only told to stop, and is not waited for. It does
+            // not access this object anymore once disableCache returned
+            void disableCache();
+
+            // returns the thread that refreshes the cache, or a null pointer
+            // if the cache is disabled
+            //
+            // together with getCacheRefreshStop, it allows to stop and join
+            // the thread before the ORB gets shut down
+            boost::shared_ptr<boost::thread> getCacheRefreshThread();
+
+            // returns a function that makes the cache refresh thread stop,
+            // or an empty function if the cache is disabled
+            //
+            // it does not access this object, and can therefore be called
+            // after this object got destroyed
+            boost::function<void()> getCacheRefreshStop();
+
+            // returns true if enableCache has been called
+            bool isCacheEnabled();
+
+            // moves the names that got added to or removed from the name
+            // service since the last call into added and removed
+            void getCacheChanges(std::vector<std::string>& added, std::vector<std::string>& removed);
+
         private:
+            struct IORResolution;
+            void resolveIORs(IORResolution* resolution);
+
+            std::vector<std::string> listTaskContextNames(size_t batch_size);
+            std::map<std::string,std::string> fetchAllIORs(size_t batch_size, size_t max_concurrency);
+            std::string resolveIOR(std::string const& name);
+
+            // returns true if the cache is enabled and not older than its TTL.
+            // cache_mutex must be locked
+            bool isCacheFresh() const;
+            void updateCache(std::map<std::string,std::string> const& iors);
+            void cacheAdd(std::string const& name, std::string const& ior);
+            void cacheRemove(std::string const& name);
+
+            struct CacheRefresh;
+            static void refreshCache(boost::shared_ptr<CacheRefresh> refresh);
+            static void stopCacheRefresh(boost::shared_ptr<CacheRefresh> refresh);
+
             CosNaming::NamingContext_var getNameService();
             CosNaming::NamingContext_var getNameService(const std::string name_service_ip, const std::string name_service_port);
 
@@ -76,7 +151,18 @@ namespace corba
             std::string name_service_ip;
             CosNaming::NamingContext_var root_context;
             boost::mutex mut;
-            bool abort_flag;
+            // set by abort() to interrupt the calls made from other threads
+            boost::atomic<bool> abort_flag;
+
+            boost::mutex cache_mutex;
+            bool cache_enabled;
+            boost::posix_time::time_duration cache_ttl;
+            boost::posix_time::ptime cache_time;
+            std::map<std::string,std::string> cache;
+            std::vector<std::string> cache_added;
+            std::vector<std::string> cache_removed;
+            boost::shared_ptr<CacheRefresh> cache_refresh;
+            boost::shared_ptr<boost::thread> cache_thread;
     };
 };
 
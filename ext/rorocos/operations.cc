@@ -1,8 +1,14 @@
 #include "rorocos.hh"
 #include "corba.hh"
 #include <memory>
+#include <list>
 #include <typeinfo>
 #include <typelib_ruby.hh>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <fcntl.h>
+#include <unistd.h>
 
 using namespace std;
 using namespace RTT::corba;
@@ -10,13 +16,16 @@ using namespace RTT::corba;
 extern VALUE cTaskContext;
 static VALUE cOperation;
 static VALUE cSendHandle;
+static VALUE cOperationCallSite;
+static VALUE cSendHandleReactor;
 
-static void corba_args_to_ruby(VALUE type_names, VALUE result, CAnyArguments& args)
+static void corba_args_to_ruby(std::vector<RTypeBinding const*> const& bindings,
+        std::vector<TypelibHandlePool*> const& handles,
+        VALUE result, CAnyArguments& args)
 {
     size_t len = RARRAY_LEN(result);
     VALUE* value_ptr = RARRAY_PTR(result);
-    VALUE* types_ptr = RARRAY_PTR(type_names);
-    
+
     if (len != args.length())
         rb_raise(rb_eArgError, "size mismatch in demarshalling of returned values (internal error), got %i elements but the CORBA array has %i", static_cast<int>(len), static_cast<int>(args.length()));
 
@@ -31,19 +40,19 @@ static void corba_args_to_ruby(VALUE type_names, VALUE result, CAnyArguments& ar
         else
         {
             Typelib::Value v = typelib_get(value_ptr[i]);
-            corba_to_ruby(StringValuePtr(types_ptr[i]), v, args[i]);
+            corba_to_ruby(*bindings[i], v, args[i], handles[i]);
         }
     }
 }
 
-static CAnyArguments* corba_args_from_ruby(VALUE type_names, VALUE args)
+static void corba_args_from_ruby(std::vector<RTypeBinding const*> const& bindings,
+        std::vector<TypelibHandlePool*> const& handles,
+        VALUE args, CAnyArguments& corba_args)
 {
-    CAnyArguments_var corba_args = new CAnyArguments;
-    corba_args->length(RARRAY_LEN(args));
-
     size_t len = RARRAY_LEN(args);
+    corba_args.length(len);
+
     VALUE* value_ptr = RARRAY_PTR(args);
-    VALUE* types_ptr = RARRAY_PTR(type_names);
     for (size_t i = 0; i < len; ++i)
     {
         if (rb_obj_is_kind_of(value_ptr[i], rb_cString))
@@ -56,31 +65,59 @@ static CAnyArguments* corba_args_from_ruby(VALUE type_names, VALUE args)
         else
         {
             Typelib::Value v = typelib_get(value_ptr[i]);
-            CORBA::Any_var arg_any = ruby_to_corba(
-                    StringValuePtr(types_ptr[i]), v);
+            CORBA::Any_var arg_any = ruby_to_corba(*bindings[i], v, handles[i]);
             corba_args[i] = arg_any;
         }
+    }
+}
 
+static void resolve_bindings(VALUE types,
+        std::vector<RTypeBinding const*>& bindings,
+        std::vector<TypelibHandlePool*>& handles)
+{
+    VALUE* types_ptr = RARRAY_PTR(types);
+    for (long i = 0; i < RARRAY_LEN(types); ++i)
+    {
+        bindings.push_back(&get_type_binding(types_ptr[i]));
+        handles.push_back(get_typelib_handle_pool(types_ptr[i]));
     }
+}
+
+static void corba_args_to_ruby(VALUE types, VALUE result, CAnyArguments& args)
+{
+    std::vector<RTypeBinding const*> bindings;
+    std::vector<TypelibHandlePool*> handles;
+    resolve_bindings(types, bindings, handles);
+    corba_args_to_ruby(bindings, handles, result, args);
+}
 
+static CAnyArguments* corba_args_from_ruby(VALUE types, VALUE args)
+{
+    std::vector<RTypeBinding const*> bindings;
+    std::vector<TypelibHandlePool*> handles;
+    resolve_bindings(types, bindings, handles);
+
+    CAnyArguments_var corba_args = new CAnyArguments;
+    corba_args_from_ruby(bindings, handles, args, corba_args.inout());
     return corba_args._retn();
 }
 
-static VALUE operation_call(VALUE task_, VALUE name, VALUE result_type_name, VALUE result, VALUE args_type_names, VALUE args)
+static VALUE operation_call(VALUE task_, VALUE name, VALUE result_type, VALUE result, VALUE args_types, VALUE args)
 {
     RTaskContext& task = get_wrapped<RTaskContext>(task_);
-    CAnyArguments_var corba_args = corba_args_from_ruby(args_type_names, args);
+    CAnyArguments_var corba_args = corba_args_from_ruby(args_types, args);
 
     CORBA::Any_var corba_result = corba_blocking_fct_call_with_result(boost::bind(&_objref_COperationInterface::callOperation,
-                (_objref_COperationInterface*)task.main_service,
+                (_objref_COperationInterface*)task.mainService(),
                 StringValuePtr(name),corba_args));
 
     if (!NIL_P(result))
     {
         Typelib::Value v = typelib_get(result);
-        corba_to_ruby(StringValuePtr(result_type_name), v, corba_result);
+        corba_to_ruby(get_type_binding(result_type), v, corba_result,
+                get_typelib_handle_pool(result_type));
     }
-    corba_args_to_ruby(args_type_names, args, corba_args);
+    corba_args_to_ruby(args_types, args, corba_args);
     return result;
 }
 
@@ -102,18 +139,158 @@ struct RSendHandle
     RTT::corba::CSendHandle_var handle;
 };
 
-static VALUE operation_send(VALUE task_, VALUE name, VALUE args_type_names, VALUE args)
+static VALUE operation_send(VALUE task_, VALUE name, VALUE args_types, VALUE args)
 {
     RTaskContext& task = get_wrapped<RTaskContext>(task_);
-    CAnyArguments_var corba_args = corba_args_from_ruby(args_type_names, args);
+    CAnyArguments_var corba_args = corba_args_from_ruby(args_types, args);
 
     RTT::corba::CSendHandle_var corba_result = corba_blocking_fct_call_with_result(boost::bind(&_objref_COperationInterface::sendOperation,
-                (_objref_COperationInterface*)task.main_service,
+                (_objref_COperationInterface*)task.mainService(),
                 StringValuePtr(name),corba_args));
     return simple_wrap(cSendHandle, new RSendHandle(corba_result));
 }
 
-static VALUE send_handle_collect_if_done(VALUE handle_, VALUE result_type_names, VALUE results)
+/** A compiled operation call site, wrapped by Orocos::OperationCallSite
+ *
+ * It holds the type bindings of the return value and arguments of an
+ * operation, and an argument buffer that is reused across calls
+ */
+struct ROperationCallSite
+{
+    VALUE task;
+    // The Ruby binding objects, kept so that the RTypeBinding and
+    // TypelibHandlePool pointers below remain valid
+    VALUE type_bindings;
+    std::string name;
+
+    RTypeBinding const* result_binding;
+    TypelibHandlePool* result_handles;
+    std::vector<RTypeBinding const*> args_bindings;
+    std::vector<TypelibHandlePool*> args_handles;
+
+    CAnyArguments_var args;
+    // Set while a call uses #args. Concurrent calls from other Ruby threads
+    // use their own buffer
+    bool busy;
+
+    ROperationCallSite()
+        : task(Qnil), type_bindings(Qnil)
+        , result_binding(0), result_handles(0)
+        , args(new CAnyArguments), busy(false) {}
+};
+
+static void call_site_mark(ROperationCallSite* site)
+{
+    rb_gc_mark(site->task);
+    rb_gc_mark(site->type_bindings);
+}
+
+static VALUE operation_compile(VALUE task_, VALUE name, VALUE result_type, VALUE args_types)
+{
+    std::auto_ptr<ROperationCallSite> site(new ROperationCallSite);
+    site->task = task_;
+    site->name = StringValuePtr(name);
+    site->type_bindings = rb_ary_dup(args_types);
+    rb_ary_push(site->type_bindings, result_type);
+
+    if (!NIL_P(result_type))
+    {
+        site->result_binding = &get_type_binding(result_type);
+        site->result_handles = get_typelib_handle_pool(result_type);
+    }
+    resolve_bindings(args_types, site->args_bindings, site->args_handles);
+    return Data_Wrap_Struct(cOperationCallSite, call_site_mark,
+            delete_object<ROperationCallSite>, site.release());
+}
+
+struct CallSiteCall
+{
+    ROperationCallSite* site;
+    VALUE result;
+    VALUE args;
+    CAnyArguments* corba_args;
+    bool uses_site_buffer;
+};
+
+static VALUE call_site_do_call(VALUE call_)
+{
+    CallSiteCall& call = *reinterpret_cast<CallSiteCall*>(call_);
+    ROperationCallSite& site = *call.site;
+    RTaskContext& task = get_wrapped<RTaskContext>(site.task);
+    corba_args_from_ruby(site.args_bindings, site.args_handles, call.args, *call.corba_args);
+
+    CORBA::Any_var corba_result = corba_blocking_fct_call_with_result(boost::bind(&_objref_COperationInterface::callOperation,
+                (_objref_COperationInterface*)task.mainService(),
+                site.name.c_str(), boost::ref(*call.corba_args)));
+
+    if (!NIL_P(call.result))
+    {
+        Typelib::Value v = typelib_get(call.result);
+        corba_to_ruby(*site.result_binding, v, corba_result, site.result_handles);
+    }
+    corba_args_to_ruby(site.args_bindings, site.args_handles, call.args, *call.corba_args);
+    return call.result;
+}
+
+static VALUE call_site_do_send(VALUE call_)
+{
+    CallSiteCall& call = *reinterpret_cast<CallSiteCall*>(call_);
+    ROperationCallSite& site = *call.site;
+    RTaskContext& task = get_wrapped<RTaskContext>(site.task);
+    corba_args_from_ruby(site.args_bindings, site.args_handles, call.args, *call.corba_args);
+
+    RTT::corba::CSendHandle_var corba_result = corba_blocking_fct_call_with_result(boost::bind(&_objref_COperationInterface::sendOperation,
+                (_objref_COperationInterface*)task.mainService(),
+                site.name.c_str(), boost::cref(*call.corba_args)));
+    return simple_wrap(cSendHandle, new RSendHandle(corba_result));
+}
+
+static VALUE call_site_release(VALUE call_)
+{
+    CallSiteCall& call = *reinterpret_cast<CallSiteCall*>(call_);
+    if (call.uses_site_buffer)
+        call.site->busy = false;
+    else
+        delete call.corba_args;
+    return Qnil;
+}
+
+static VALUE call_site_run(VALUE self, VALUE (*body)(VALUE), VALUE result, VALUE args)
+{
+    ROperationCallSite& site = get_wrapped<ROperationCallSite>(self);
+    if (static_cast<size_t>(RARRAY_LEN(args)) != site.args_bindings.size())
+        rb_raise(rb_eArgError, "expected %i arguments but got %i",
+                static_cast<int>(site.args_bindings.size()),
+                static_cast<int>(RARRAY_LEN(args)));
+
+    CallSiteCall call;
+    call.site = &site;
+    call.result = result;
+    call.args = args;
+    call.uses_site_buffer = !site.busy;
+    if (call.uses_site_buffer)
+    {
+        site.busy = true;
+        call.corba_args = site.args.ptr();
+    }
+    else
+        call.corba_args = new CAnyArguments;
+
+    return rb_ensure(RUBY_METHOD_FUNC(body), reinterpret_cast<VALUE>(&call),
+            RUBY_METHOD_FUNC(call_site_release), reinterpret_cast<VALUE>(&call));
+}
+
+static VALUE call_site_call(VALUE self, VALUE result, VALUE args)
+{
+    return call_site_run(self, &call_site_do_call, result, args);
+}
+
+static VALUE call_site_send(VALUE self, VALUE args)
+{
+    return call_site_run(self, &call_site_do_send, Qnil, args);
+}
+
+static VALUE send_handle_collect_if_done(VALUE handle_, VALUE result_types, VALUE results)
 {
     RSendHandle& handle = get_wrapped<RSendHandle>(handle_);
     CAnyArguments_var corba_result = new CAnyArguments;
@@ -121,11 +298,11 @@ static VALUE send_handle_collect_if_done(VALUE handle_, VALUE result_type_names,
     CSendStatus ss = corba_blocking_fct_call_with_result(boost::bind(&_objref_CSendHandle::collectIfDone,
                 (CSendHandle_ptr)handle.handle,(CAnyArguments_out)corba_result));
     if (ss == RTT::corba::CSendSuccess)
-        corba_args_to_ruby(result_type_names, results, corba_result);
+        corba_args_to_ruby(result_types, results, corba_result);
     return INT2FIX(ss);
 }
 
-static VALUE send_handle_collect(VALUE handle_, VALUE result_type_names, VALUE results)
+static VALUE send_handle_collect(VALUE handle_, VALUE result_types, VALUE results)
 {
     RSendHandle& handle = get_wrapped<RSendHandle>(handle_);
     CAnyArguments_var corba_result = new CAnyArguments;
@@ -133,26 +310,293 @@ static VALUE send_handle_collect(VALUE handle_, VALUE result_type_names, VALUE r
     CSendStatus ss = corba_blocking_fct_call_with_result(boost::bind(&_objref_CSendHandle::collect,
                 (CSendHandle_ptr)handle.handle,(CAnyArguments_out)corba_result));
     if (ss == RTT::corba::CSendSuccess)
-        corba_args_to_ruby(result_type_names, results, corba_result);
+        corba_args_to_ruby(result_types, results, corba_result);
     return INT2FIX(ss);
 }
 
+/** Monitors the completion of send handles from a background thread
+ *
+ * The thread polls the watched handles with collectIfDone, concurrently and
+ * off the GVL, and queues the ones that are finished. Ruby is notified by
+ * writing on a pipe, whose read end can be given to IO.select. It then gets
+ * all the completions queued so far with drain()
+ *
+ * The state shared with the thread is reference-counted, so that the reactor
+ * can be destroyed from the GC without waiting for the thread: the thread
+ * releases the state itself once it noticed that it should quit. The thread
+ * is registered with corba_register_background_thread, so that it gets
+ * stopped and joined before the ORB gets shut down
+ */
+class SendHandleReactor
+{
+public:
+    struct Completion
+    {
+        long id;
+        CSendStatus status;
+        CAnyArguments_var results;
+        CORBACallStatus error;
+    };
+
+    SendHandleReactor(double period)
+        : state(new State(period))
+    {
+        boost::shared_ptr<boost::thread> thread(
+                new boost::thread(boost::bind(&SendHandleReactor::run, state)));
+        corba_register_background_thread(thread,
+                boost::bind(&SendHandleReactor::stop, state));
+    }
+
+    ~SendHandleReactor()
+    {
+        stop(state);
+    }
+
+    int wakeupFD() const { return state->wakeup_fds[0]; }
+
+    void watch(long id, CSendHandle_ptr handle)
+    {
+        {
+            boost::mutex::scoped_lock lock(state->mutex);
+            Watch watch = { id, CSendHandle::_duplicate(handle) };
+            state->added.push_back(watch);
+        }
+        state->cond.notify_all();
+    }
+
+    /** Returns the completions queued so far
+     *
+     * The pipe is emptied under the lock, before taking the completions, as
+     * the thread queues completions and writes on the pipe under that same
+     * lock. Emptying it afterwards could consume the notification of
+     * completions queued in-between
+     */
+    void drain(std::list<Completion>& result)
+    {
+        boost::mutex::scoped_lock lock(state->mutex);
+        char buffer[64];
+        while (read(state->wakeup_fds[0], buffer, sizeof(buffer)) > 0);
+        result.splice(result.end(), state->completed);
+    }
+
+private:
+    struct Watch
+    {
+        long id;
+        CSendHandle_var handle;
+    };
+
+    struct State
+    {
+        boost::posix_time::time_duration period;
+        boost::mutex mutex;
+        boost::condition_variable cond;
+        bool quit;
+        std::list<Watch> added;
+        std::list<Completion> completed;
+        int wakeup_fds[2];
+
+        State(double period)
+            : period(boost::posix_time::microseconds(static_cast<long>(period * 1e6)))
+            , quit(false)
+        {
+            if (pipe(wakeup_fds) == -1)
+                throw std::runtime_error("cannot create the reactor's wakeup pipe");
+            for (int i = 0; i < 2; ++i)
+                fcntl(wakeup_fds[i], F_SETFL, fcntl(wakeup_fds[i], F_GETFL) | O_NONBLOCK);
+        }
+
+        ~State()
+        {
+            close(wakeup_fds[0]);
+            close(wakeup_fds[1]);
+        }
+    };
+
+    /** Makes the thread quit
+     *
+     * The handles that the thread did not pick up yet are released here, as
+     * the state may outlive the ORB
+     */
+    static void stop(boost::shared_ptr<State> state)
+    {
+        {
+            boost::mutex::scoped_lock lock(state->mutex);
+            state->quit = true;
+            state->added.clear();
+        }
+        state->cond.notify_all();
+    }
+
+    static void collectIfDone(CSendHandle_ptr handle, Completion* completion)
+    {
+        completion->status = handle->collectIfDone(completion->results.out());
+    }
+
+    static void run(boost::shared_ptr<State> state)
+    {
+        std::list<Watch> watched;
+        while (true)
+        {
+            {
+                boost::mutex::scoped_lock lock(state->mutex);
+                if (watched.empty() && state->added.empty() && !state->quit)
+                    state->cond.wait(lock);
+                if (state->quit)
+                    return;
+                watched.splice(watched.end(), state->added);
+            }
+
+            std::vector<Completion> polled(watched.size());
+            std::vector< boost::function<void()> > calls;
+            std::list<Watch>::iterator it = watched.begin();
+            for (size_t i = 0; i < polled.size(); ++i, ++it)
+            {
+                polled[i].id = it->id;
+                calls.push_back(boost::bind(&SendHandleReactor::collectIfDone,
+                            it->handle.in(), &polled[i]));
+            }
+            std::vector<CORBACallStatus> status;
+            corba_multi_call(calls, status);
+
+            std::list<Completion> done;
+            it = watched.begin();
+            for (size_t i = 0; i < polled.size(); ++i)
+            {
+                polled[i].error = status[i];
+                if (status[i].failed() || polled[i].status != RTT::corba::CSendNotReady)
+                {
+                    done.push_back(polled[i]);
+                    it = watched.erase(it);
+                }
+                else ++it;
+            }
+
+            boost::mutex::scoped_lock lock(state->mutex);
+            if (!done.empty())
+            {
+                state->completed.splice(state->completed.end(), done);
+                char c = 0;
+                if (write(state->wakeup_fds[1], &c, 1) == -1)
+                {
+                    // The pipe is full, which means that Ruby already has
+                    // a pending notification
+                }
+            }
+            if (!state->quit && !watched.empty())
+                state->cond.timed_wait(lock, state->period);
+        }
+    }
+
+    boost::shared_ptr<State> state;
+};
+
+static VALUE send_handle_reactor_new(VALUE klass, VALUE period)
+{
+    SendHandleReactor* reactor = 0;
+    try { reactor = new SendHandleReactor(NUM2DBL(period)); }
+    catch(std::exception& e)
+    { rb_raise(rb_eRuntimeError, "%s", e.what()); }
+    return Data_Wrap_Struct(klass, 0, delete_object<SendHandleReactor>, reactor);
+}
+
+static VALUE send_handle_reactor_wakeup_fd(VALUE self)
+{
+    return INT2FIX(get_wrapped<SendHandleReactor>(self).wakeupFD());
+}
+
+static VALUE send_handle_reactor_watch(VALUE self, VALUE id, VALUE handle)
+{
+    SendHandleReactor& reactor = get_wrapped<SendHandleReactor>(self);
+    reactor.watch(NUM2LONG(id), get_wrapped<RSendHandle>(handle).handle.in());
+    return Qnil;
+}
+
+// Arguments of send_handle_reactor_convert, passed through rb_protect
+struct SendHandleReactorConversion
+{
+    VALUE handle;
+    CAnyArguments* results;
+};
+
+static VALUE send_handle_reactor_convert(VALUE _conversion)
+{
+    SendHandleReactorConversion& conversion =
+        *reinterpret_cast<SendHandleReactorConversion*>(_conversion);
+    corba_args_to_ruby(rb_iv_get(conversion.handle, "@return_type_bindings"),
+            rb_iv_get(conversion.handle, "@return_values"), *conversion.results);
+    return Qnil;
+}
+
+// Gets the completions queued by the reactor thread, and stores the results
+// of the successful ones in the return values of the corresponding send
+// handle in +pending+ (a hash of ID to send handle)
+//
+// Returns a list of [id, status, exception], where exception is nil unless
+// the handle could not be polled or its results could not be converted. The
+// conversions are done under rb_protect so that a failing one does not lose
+// the other completions
+static VALUE send_handle_reactor_drain(VALUE self, VALUE pending)
+{
+    SendHandleReactor& reactor = get_wrapped<SendHandleReactor>(self);
+    std::list<SendHandleReactor::Completion> completions;
+    reactor.drain(completions);
+
+    VALUE result = rb_ary_new();
+    for (std::list<SendHandleReactor::Completion>::iterator it = completions.begin();
+            it != completions.end(); ++it)
+    {
+        VALUE exception = Qnil;
+        VALUE id = LONG2NUM(it->id);
+        if (it->error.failed())
+        {
+            exception = rb_exc_new(it->error.exception_class,
+                    it->error.exception_message.c_str(),
+                    it->error.exception_message.size());
+        }
+        else if (it->status == RTT::corba::CSendSuccess)
+        {
+            VALUE handle = rb_hash_aref(pending, id);
+            if (!NIL_P(handle))
+            {
+                SendHandleReactorConversion conversion = { handle, &it->results.inout() };
+                int state = 0;
+                rb_protect(send_handle_reactor_convert,
+                        reinterpret_cast<VALUE>(&conversion), &state);
+                if (state)
+                {
+                    exception = rb_errinfo();
+                    rb_set_errinfo(Qnil);
+                    if (NIL_P(exception))
+                        exception = rb_exc_new2(rb_eRuntimeError, "interrupted while converting the results");
+                }
+            }
+        }
+        VALUE entry = rb_ary_new();
+        rb_ary_push(entry, id);
+        rb_ary_push(entry, NIL_P(exception) ? INT2FIX(it->status) : Qnil);
+        rb_ary_push(entry, exception);
+        rb_ary_push(result, entry);
+    }
+    return result;
+}
+
 static VALUE operation_return_types(VALUE task_, VALUE opname)
 {
     RTaskContext& task = get_wrapped<RTaskContext>(task_);
 
     VALUE result = rb_ary_new();
         int retcount = corba_blocking_fct_call_with_result(boost::bind(&_objref_COperationInterface::getCollectArity,
-                (_objref_COperationInterface*)task.main_service,StringValuePtr(opname)));
+                (_objref_COperationInterface*)task.mainService(),StringValuePtr(opname)));
 
         CORBA::String_var type_name = corba_blocking_fct_call_with_result(boost::bind(&_objref_COperationInterface::getResultType,
-                (_objref_COperationInterface*)task.main_service,StringValuePtr(opname)));
+                (_objref_COperationInterface*)task.mainService(),StringValuePtr(opname)));
         rb_ary_push(result, rb_str_new2(type_name));
 
         for (int i = 0; i < retcount - 1; ++i)
         {
             type_name = corba_blocking_fct_call_with_result(boost::bind(&_objref_COperationInterface::getCollectType,
-                (_objref_COperationInterface*)task.main_service,StringValuePtr(opname),i+1));
+                (_objref_COperationInterface*)task.mainService(),StringValuePtr(opname),i+1));
             rb_ary_push(result, rb_str_new2(type_name));
         }
         return result;
@@ -166,10 +610,10 @@ static VALUE operation_argument_types(VALUE task_, VALUE opname)
 
     #if RTT_VERSION_GTE(2,8,99)
         RTT::corba::CArgumentDescriptions_var args = corba_blocking_fct_call_with_result(boost::bind(&_objref_COperationInterface::getArguments,
-                (_objref_COperationInterface*)task.main_service,StringValuePtr(opname)));
+                (_objref_COperationInterface*)task.mainService(),StringValuePtr(opname)));
     #else
         RTT::corba::CDescriptions_var args = corba_blocking_fct_call_with_result(boost::bind(&_objref_COperationInterface::getArguments,
-                (_objref_COperationInterface*)task.main_service,StringValuePtr(opname)));
+                (_objref_COperationInterface*)task.mainService(),StringValuePtr(opname)));
     #endif
 
     for (unsigned int i = 0; i < args->length(); ++i)
@@ -191,14 +635,25 @@ void Orocos_init_methods()
     VALUE mOrocos = rb_define_module("Orocos");
     cOperation   = rb_define_class_under(mOrocos, "Operation",  rb_cObject);
     cSendHandle  = rb_define_class_under(mOrocos, "SendHandle", rb_cObject);
+    cOperationCallSite = rb_define_class_under(mOrocos, "OperationCallSite", rb_cObject);
 
     rb_define_method(cTaskContext, "operation_return_types", RUBY_METHOD_FUNC(operation_return_types), 1);
     rb_define_method(cTaskContext, "operation_argument_types", RUBY_METHOD_FUNC(operation_argument_types), 1);
     rb_define_method(cTaskContext, "do_operation_call", RUBY_METHOD_FUNC(operation_call), 5);
     rb_define_method(cTaskContext, "do_operation_send", RUBY_METHOD_FUNC(operation_send), 3);
+    rb_define_method(cTaskContext, "do_operation_compile", RUBY_METHOD_FUNC(operation_compile), 3);
+    rb_define_method(cOperationCallSite, "do_call", RUBY_METHOD_FUNC(call_site_call), 2);
+    rb_define_method(cOperationCallSite, "do_send", RUBY_METHOD_FUNC(call_site_send), 1);
     rb_define_method(cSendHandle, "do_operation_collect", RUBY_METHOD_FUNC(send_handle_collect), 2);
     rb_define_method(cSendHandle, "do_operation_collect_if_done", RUBY_METHOD_FUNC(send_handle_collect_if_done), 2);
 
+    VALUE cSendHandleReactorBase = rb_define_class_under(mOrocos, "SendHandleReactor", rb_cObject);
+    cSendHandleReactor = rb_define_class_under(cSendHandleReactorBase, "NativeReactor", rb_cObject);
+    rb_define_singleton_method(cSendHandleReactor, "new", RUBY_METHOD_FUNC(send_handle_reactor_new), 1);
+    rb_define_method(cSendHandleReactor, "wakeup_fd", RUBY_METHOD_FUNC(send_handle_reactor_wakeup_fd), 0);
+    rb_define_method(cSendHandleReactor, "do_watch", RUBY_METHOD_FUNC(send_handle_reactor_watch), 2);
+    rb_define_method(cSendHandleReactor, "do_drain", RUBY_METHOD_FUNC(send_handle_reactor_drain), 1);
+
     rb_const_set(mOrocos, rb_intern("SEND_SUCCESS"),       INT2FIX(RTT::corba::CSendSuccess));
     rb_const_set(mOrocos, rb_intern("SEND_NOT_READY"),     INT2FIX(RTT::corba::CSendNotReady));
     rb_const_set(mOrocos, rb_intern("SEND_FAILURE"),       INT2FIX(RTT::corba::CSendFailure));
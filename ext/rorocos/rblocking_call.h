@@ -189,4 +189,55 @@ typename F::result_type blocking_fct_call_with_result(F processing)
     return BlockingFunctionWithResult<F>::call(processing);
 }
 
+/** Calls +processing+ with the GVL released, calling +abort+ if the Ruby
+ * thread gets interrupted in the meantime
+ *
+ * Unlike blocking_fct_call, this does not process the interrupts once
+ * +processing+ returned, i.e. it never raises, and +processing+ is not
+ * called at all if an interrupt is already pending. This allows to report
+ * the interrupt through the caller's own error handling, the interrupt
+ * itself being processed at the next interrupt check. Neither +processing+
+ * nor +abort+ may throw
+ */
+template<typename F, typename A>
+class NonRaisingBlockingFunction
+{
+    public:
+        static void call(F processing, A abort)
+        {
+            orocos_verify_thread_interdiction();
+            NonRaisingBlockingFunction bf(processing, abort);
+#if defined HAVE_RUBY_INTERN_H
+            rb_thread_call_without_gvl2(&NonRaisingBlockingFunction::callProcessing, &bf,
+                    &NonRaisingBlockingFunction::callAbort, &bf);
+#else
+            callProcessing(&bf);
+#endif
+        }
+
+    private:
+        NonRaisingBlockingFunction(F processing, A abort)
+            : processing_fct(processing), abort_fct(abort) { }
+
+        static void* callProcessing(void* ptr)
+        {
+            reinterpret_cast<NonRaisingBlockingFunction*>(ptr)->processing_fct();
+            return NULL;
+        }
+
+        static void callAbort(void* ptr)
+        {
+            reinterpret_cast<NonRaisingBlockingFunction*>(ptr)->abort_fct();
+        }
+
+        F processing_fct;
+        A abort_fct;
+};
+
+template<typename F, typename A>
+void non_raising_blocking_fct_call(F processing, A abort)
+{
+    NonRaisingBlockingFunction<F,A>::call(processing,abort);
+}
+
 #endif
@@ -1,5 +1,6 @@
 #include <typeinfo>
 
+#include <map>
 #include <memory>
 #include <boost/tuple/tuple.hpp>
 
@@ -50,6 +51,7 @@ static VALUE cInputPort;
 static VALUE cOutputPort;
 static VALUE cPortAccess;
 static VALUE cPort;
+static VALUE cTypeBinding;
 static VALUE eConnectionFailed;
 static VALUE eStateTransitionFailed;
 
@@ -103,14 +105,180 @@ orogen_transports::TypelibMarshallerBase* get_typelib_transport(RTT::types::Type
         return 0;
 }
 
+// Resolves the binding of the given type. Returns false if the type is not
+// registered in the RTT type system
+static bool resolve_type_binding(RTypeBinding& binding, std::string const& name)
+{
+    binding.type_info = get_type_info(name, false);
+    if (!binding.type_info)
+        return false;
+    binding.corba_transport = get_corba_transport(binding.type_info, false);
+    binding.typelib_transport = get_typelib_transport(binding.type_info, false);
+    binding.plain = !binding.typelib_transport || binding.typelib_transport->isPlainTypelibType();
+    return true;
+}
+
+// Bindings are never modified nor deleted once resolved, as TypeBinding
+// objects and the readers running without the GVL reference them. The
+// references we return are therefore valid for the lifetime of the process.
+// refresh_type_bindings() replaces the incomplete ones instead.
+typedef std::map<std::string, RTypeBinding*> TypeBindings;
+static TypeBindings type_bindings;
+static boost::mutex type_bindings_mutex;
+
+RTypeBinding const& get_type_binding(std::string const& name)
+{
+    RTypeBinding const* result = 0;
+    {
+        boost::mutex::scoped_lock lock(type_bindings_mutex);
+        TypeBindings::const_iterator it = type_bindings.find(name);
+        if (it != type_bindings.end())
+            result = it->second;
+        else
+        {
+            std::auto_ptr<RTypeBinding> binding(new RTypeBinding);
+            if (resolve_type_binding(*binding, name))
+            {
+                result = binding.get();
+                type_bindings[name] = binding.release();
+            }
+        }
+    }
+
+    if (!result)
+        rb_raise(rb_eArgError, "type '%s' is not registered in the RTT type system", name.c_str());
+    return *result;
+}
+
+/** Resolves again the bindings that are missing a transport
+ *
+ * It must be called when typekits or transports are loaded, as they may
+ * provide the missing transports. The new bindings are used by the
+ * TypeBinding objects created afterwards, the existing ones keep the binding
+ * they have been created with
+ */
+static void refresh_type_bindings()
+{
+    boost::mutex::scoped_lock lock(type_bindings_mutex);
+    for (TypeBindings::iterator it = type_bindings.begin(); it != type_bindings.end(); ++it)
+    {
+        RTypeBinding const& current = *it->second;
+        if (current.corba_transport && current.typelib_transport)
+            continue;
+
+        RTypeBinding binding;
+        if (!resolve_type_binding(binding, it->first))
+            continue;
+        if (binding.corba_transport != current.corba_transport ||
+                binding.typelib_transport != current.typelib_transport)
+        {
+            // The old binding is leaked on purpose, see type_bindings
+            it->second = new RTypeBinding(binding);
+        }
+    }
+}
+
+RTypeBinding const& get_type_binding(VALUE binding_or_name)
+{
+    if (rb_obj_is_kind_of(binding_or_name, cTypeBinding))
+        return get_wrapped<RTypeBindingObject>(binding_or_name).binding;
+    return get_type_binding(std::string(StringValuePtr(binding_or_name)));
+}
+
+TypelibHandlePool* get_typelib_handle_pool(VALUE binding_or_name)
+{
+    if (rb_obj_is_kind_of(binding_or_name, cTypeBinding))
+        return &get_wrapped<RTypeBindingObject>(binding_or_name).handles;
+    return 0;
+}
+
+TypelibHandlePool::TypelibHandlePool(size_t max_size)
+    : transport(0)
+    , max_size(max_size) {}
+
+TypelibHandlePool::~TypelibHandlePool()
+{
+    for (std::vector<Handle*>::iterator it = handles.begin(); it != handles.end(); ++it)
+        transport->deleteHandle(*it);
+}
+
+TypelibHandlePool::Handle* TypelibHandlePool::acquire(orogen_transports::TypelibMarshallerBase* transport)
+{
+    std::vector<Handle*> stale;
+    Handle* handle = 0;
+    orogen_transports::TypelibMarshallerBase* stale_transport;
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        if (this->transport != transport)
+        {
+            stale.swap(handles);
+            stale_transport = this->transport;
+            this->transport = transport;
+        }
+        else if (!handles.empty())
+        {
+            handle = handles.back();
+            handles.pop_back();
+        }
+    }
+
+    for (std::vector<Handle*>::iterator it = stale.begin(); it != stale.end(); ++it)
+        stale_transport->deleteHandle(*it);
+    if (handle)
+        return handle;
+    return transport->createHandle();
+}
+
+void TypelibHandlePool::release(orogen_transports::TypelibMarshallerBase* transport, Handle* handle)
+{
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        if (this->transport == transport && handles.size() < max_size)
+        {
+            handles.push_back(handle);
+            return;
+        }
+    }
+    transport->deleteHandle(handle);
+}
+
+TypelibHandle::TypelibHandle(RTypeBinding const& binding, TypelibHandlePool* pool)
+    : transport(binding.typelib_transport)
+    , pool(pool)
+{
+    if (pool)
+        handle = pool->acquire(transport);
+    else
+        handle = transport->createHandle();
+}
+
+TypelibHandle::~TypelibHandle()
+{
+    if (pool)
+        pool->release(transport, handle);
+    else
+        transport->deleteHandle(handle);
+}
+
+void refresh_typelib_value(orogen_transports::TypelibMarshallerBase* transport,
+        TypelibHandlePool::Handle* handle, Typelib::Value dest)
+{
+    transport->refreshTypelibSample(handle);
+    uint8_t* typelib_sample = transport->getTypelibSample(handle);
+    if (typelib_sample != dest.getData())
+        Typelib::copy(dest, Typelib::Value(typelib_sample, dest.getType()));
+}
+
+static ID id_iv_task;
+static ID id_iv_name;
+
 boost::tuple<RTaskContext*, VALUE, VALUE> getPortReference(VALUE port)
 {
-    VALUE task = rb_iv_get(port, "@task");
-    VALUE task_name = rb_iv_get(task, "@name");
-    VALUE port_name = rb_iv_get(port, "@name");
+    VALUE task = rb_ivar_get(port, id_iv_task);
+    VALUE port_name = rb_ivar_get(port, id_iv_name);
 
     RTaskContext& task_context = get_wrapped<RTaskContext>(task);
-    return boost::make_tuple(&task_context, task_name, port_name);
+    return boost::make_tuple(&task_context, task, port_name);
 }
 
 // call-seq:
@@ -120,6 +288,11 @@ boost::tuple<RTaskContext*, VALUE, VALUE> getPortReference(VALUE port)
 // with the given ior. Raises Orocos::NotFound if the task does
 // not exist. Use the CORBA name service to retrieve a task
 // by its name.
+//
+// The references are cached per IOR. The liveness of the remote task is
+// checked only if it was not in the last
+// CorbaAccess::CACHE_VALIDATION_PERIOD, so a task that died in the meantime is
+// reported by the first call made on it instead.
 ///
 VALUE task_context_create(int argc, VALUE *argv,VALUE klass)
 {
@@ -155,7 +328,7 @@ static VALUE task_context_equal_p(VALUE self, VALUE other)
 static VALUE task_context_has_port_p(VALUE self, VALUE name)
 {
     RTaskContext& context = get_wrapped<RTaskContext>(self);
-    corba_blocking_fct_call(bind(&_objref_CDataFlowInterface::getPortType,(CDataFlowInterface_ptr)context.ports,StringValuePtr(name)));
+    corba_blocking_fct_call(bind(&_objref_CDataFlowInterface::getPortType,(CDataFlowInterface_ptr)context.dataFlow(),StringValuePtr(name)));
     return Qtrue;
 }
 
@@ -168,7 +341,7 @@ static VALUE task_context_real_name(VALUE self)
 static VALUE task_context_has_operation_p(VALUE self, VALUE name)
 {
     RTaskContext& context = get_wrapped<RTaskContext>(self);
-    corba_blocking_fct_call(bind(&_objref_COperationInterface::getResultType,(_objref_COperationInterface*)context.main_service,StringValuePtr(name)));
+    corba_blocking_fct_call(bind(&_objref_COperationInterface::getResultType,(_objref_COperationInterface*)context.mainService(),StringValuePtr(name)));
     return Qtrue;
 }
 
@@ -177,7 +350,7 @@ static VALUE task_context_attribute_type_name(VALUE self, VALUE name)
     RTaskContext& context = get_wrapped<RTaskContext>(self);
     std::string const expected_name = StringValuePtr(name);
     CORBA::String_var attribute_type_name =
-        corba_blocking_fct_call_with_result(bind(&_objref_CConfigurationInterface::getAttributeTypeName,(_objref_CConfigurationInterface*)context.main_service,StringValuePtr(name)));
+        corba_blocking_fct_call_with_result(bind(&_objref_CConfigurationInterface::getAttributeTypeName,(_objref_CConfigurationInterface*)context.mainService(),StringValuePtr(name)));
     std::string type_name = std::string(attribute_type_name);
     if (type_name != "na")
         return rb_str_new(type_name.c_str(), type_name.length());
@@ -191,7 +364,7 @@ static VALUE task_context_property_type_name(VALUE self, VALUE name)
     RTaskContext& context = get_wrapped<RTaskContext>(self);
     std::string const expected_name = StringValuePtr(name);
     CORBA::String_var attribute_type_name =
-        corba_blocking_fct_call_with_result(bind(&_objref_CConfigurationInterface::getPropertyTypeName,(_objref_CConfigurationInterface*)context.main_service,StringValuePtr(name)));
+        corba_blocking_fct_call_with_result(bind(&_objref_CConfigurationInterface::getPropertyTypeName,(_objref_CConfigurationInterface*)context.mainService(),StringValuePtr(name)));
     std::string type_name = std::string(attribute_type_name);
     if (type_name != "na")
         return rb_str_new(type_name.c_str(), type_name.length());
@@ -206,7 +379,7 @@ static VALUE task_context_property_names(VALUE self)
 
     VALUE result = rb_ary_new();
     RTT::corba::CConfigurationInterface::CPropertyNames_var names =
-        corba_blocking_fct_call_with_result(bind(&_objref_CConfigurationInterface::getPropertyList,(_objref_CConfigurationInterface*)context.main_service));
+        corba_blocking_fct_call_with_result(bind(&_objref_CConfigurationInterface::getPropertyList,(_objref_CConfigurationInterface*)context.mainService()));
     for (unsigned int i = 0; i != names->length(); ++i)
     {
         CORBA::String_var name = names[i].name;
@@ -221,7 +394,7 @@ static VALUE task_context_attribute_names(VALUE self)
 
     VALUE result = rb_ary_new();
     RTT::corba::CConfigurationInterface::CAttributeNames_var names =
-        corba_blocking_fct_call_with_result(bind(&_objref_CConfigurationInterface::getAttributeList,(_objref_CConfigurationInterface*)context.main_service));
+        corba_blocking_fct_call_with_result(bind(&_objref_CConfigurationInterface::getAttributeList,(_objref_CConfigurationInterface*)context.mainService()));
     for (unsigned int i = 0; i != names->length(); ++i)
     {
         #if RTT_VERSION_GTE(2,8,99)
@@ -241,10 +414,10 @@ static VALUE task_context_operation_names(VALUE self)
     VALUE result = rb_ary_new();
     #if RTT_VERSION_GTE(2,8,99)
         RTT::corba::COperationInterface::COperationDescriptions_var names =
-                corba_blocking_fct_call_with_result(bind(&_objref_COperationInterface::getOperations,(_objref_COperationInterface*)context.main_service));
+                corba_blocking_fct_call_with_result(bind(&_objref_COperationInterface::getOperations,(_objref_COperationInterface*)context.mainService()));
     #else
         RTT::corba::COperationInterface::COperationList_var names =
-                corba_blocking_fct_call_with_result(bind(&_objref_COperationInterface::getOperations,(_objref_COperationInterface*)context.main_service));
+                corba_blocking_fct_call_with_result(bind(&_objref_COperationInterface::getOperations,(_objref_COperationInterface*)context.mainService()));
     #endif
 
     for (unsigned int i = 0; i != names->length(); ++i)
@@ -259,31 +432,6 @@ static VALUE task_context_operation_names(VALUE self)
     return result;
 }
 
-// call-seq:
-//   task.do_port(name) => port
-//
-// Returns the Orocos::DataPort or Orocos::BufferPort object representing the
-// remote port +name+. Raises NotFound if the port does not exist. This is an
-// internal method. Use TaskContext#port to get a port object.
-///
-static VALUE task_context_do_port(VALUE self, VALUE name, VALUE model)
-{
-    RTaskContext& context = get_wrapped<RTaskContext>(self);
-    RTT::corba::CPortType port_type;
-    CORBA::String_var    type_name;
-    port_type = corba_blocking_fct_call_with_result(bind(&_objref_CDataFlowInterface::getPortType,(_objref_CDataFlowInterface*)context.ports,StringValuePtr(name)));
-    type_name = corba_blocking_fct_call_with_result(bind(&_objref_CDataFlowInterface::getDataType,(_objref_CDataFlowInterface*)context.ports,StringValuePtr(name)));
-
-    VALUE obj = Qnil;
-    VALUE args[4] = { self, rb_str_dup(name), rb_str_new2(type_name), model };
-    if (port_type == RTT::corba::CInput)
-        obj = rb_class_new_instance(4, args, cInputPort);
-    else if (port_type == RTT::corba::COutput)
-        obj = rb_class_new_instance(4, args, cOutputPort);
-
-    return obj;
-}
-
 static VALUE orocos_registered_type_p(VALUE mod, VALUE type_name)
 {
     RTT::types::TypeInfo* ti = get_type_info(static_cast<char const*>(StringValuePtr(type_name)), false);
@@ -306,12 +454,182 @@ static VALUE orocos_typelib_type_for(VALUE mod, VALUE type_name)
     else return Qnil;
 }
 
+// call-seq:
+//  Orocos.do_type_binding(type_name) => binding
+//
+// Returns a new Orocos::TypeBinding object that caches the RTT type information
+// for the given type, along with a pool of marshaller handles. Raises
+// ArgumentError if the type is not registered in the RTT type system.
+static VALUE orocos_type_binding(VALUE mod, VALUE type_name)
+{
+    RTypeBinding const& binding = get_type_binding(std::string(StringValuePtr(type_name)));
+    return Data_Wrap_Struct(cTypeBinding, 0, delete_object<RTypeBindingObject>, new RTypeBindingObject(binding));
+}
+
+#if RTT_VERSION_GTE(2,8,99)
+typedef RTT::corba::COperationInterface::COperationDescriptions_var COperationList_var;
+#else
+typedef RTT::corba::COperationInterface::COperationList_var COperationList_var;
+#endif
+
+static void describe_ports(_objref_CDataFlowInterface* ports, CDataFlowInterface::CPortDescriptions_var* result)
+{ *result = ports->getPortDescriptions(); }
+static void describe_properties(_objref_CConfigurationInterface* config, CConfigurationInterface::CPropertyNames_var* result)
+{ *result = config->getPropertyList(); }
+static void describe_attributes(_objref_CConfigurationInterface* config, CConfigurationInterface::CAttributeNames_var* result)
+{ *result = config->getAttributeList(); }
+static void describe_operations(_objref_COperationInterface* operations, COperationList_var* result)
+{ *result = operations->getOperations(); }
+static void describe_property_type(_objref_CConfigurationInterface* config, std::string const* name, CORBA::String_var* result)
+{ *result = config->getPropertyTypeName(name->c_str()); }
+static void describe_attribute_type(_objref_CConfigurationInterface* config, std::string const* name, CORBA::String_var* result)
+{ *result = config->getAttributeTypeName(name->c_str()); }
+
+static bool first_failure(std::vector<CORBACallStatus> const& status, VALUE& exception_class, std::string& exception_message)
+{
+    for (size_t i = 0; i < status.size(); ++i)
+    {
+        if (status[i].failed())
+        {
+            exception_class = status[i].exception_class;
+            exception_message = status[i].exception_message;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Converts port descriptions into an array of [name, input_port?, type_name]
+static VALUE port_descriptions_to_ruby(CDataFlowInterface::CPortDescriptions const& ports)
+{
+    VALUE result = rb_ary_new();
+    for (unsigned int i = 0; i != ports.length(); ++i)
+    {
+        VALUE desc = rb_ary_new();
+        rb_ary_push(desc, rb_str_new2(ports[i].name));
+        rb_ary_push(desc, ports[i].type == RTT::corba::CInput ? Qtrue : Qfalse);
+        rb_ary_push(desc, rb_str_new2(ports[i].type_name));
+        rb_ary_push(result, desc);
+    }
+    return result;
+}
+
+// Helper for task_context_describe
+//
+// Errors are returned in +exception_class+ and +exception_message+ instead of
+// being raised, so that the C++ objects are destroyed before the Ruby
+// exception is raised
+static VALUE describe_task(RTaskContext& context, VALUE& exception_class, std::string& exception_message)
+{
+    _objref_CConfigurationInterface* config = (_objref_CConfigurationInterface*)context.mainService();
+
+    CDataFlowInterface::CPortDescriptions_var ports;
+    CConfigurationInterface::CPropertyNames_var properties;
+    CConfigurationInterface::CAttributeNames_var attributes;
+    COperationList_var operations;
+
+    std::vector< boost::function<void()> > calls;
+    calls.push_back(boost::bind(&describe_ports, (_objref_CDataFlowInterface*)context.dataFlow(), &ports));
+    calls.push_back(boost::bind(&describe_properties, config, &properties));
+    calls.push_back(boost::bind(&describe_attributes, config, &attributes));
+    calls.push_back(boost::bind(&describe_operations, (_objref_COperationInterface*)context.mainService(), &operations));
+    std::vector<CORBACallStatus> status;
+    corba_blocking_multi_call(calls, status);
+    if (first_failure(status, exception_class, exception_message))
+        return Qnil;
+
+    std::vector<std::string> property_names;
+    for (unsigned int i = 0; i != properties->length(); ++i)
+        property_names.push_back(properties[i].name.in());
+    std::vector<std::string> attribute_names;
+    for (unsigned int i = 0; i != attributes->length(); ++i)
+    {
+        #if RTT_VERSION_GTE(2,8,99)
+            attribute_names.push_back(attributes[i].name.in());
+        #else
+            attribute_names.push_back(attributes[i].in());
+        #endif
+    }
+
+    std::vector<CORBA::String_var> property_types(property_names.size());
+    std::vector<CORBA::String_var> attribute_types(attribute_names.size());
+    calls.clear();
+    for (size_t i = 0; i < property_names.size(); ++i)
+        calls.push_back(boost::bind(&describe_property_type, config, &property_names[i], &property_types[i]));
+    for (size_t i = 0; i < attribute_names.size(); ++i)
+        calls.push_back(boost::bind(&describe_attribute_type, config, &attribute_names[i], &attribute_types[i]));
+    corba_blocking_multi_call(calls, status);
+    if (first_failure(status, exception_class, exception_message))
+        return Qnil;
+
+    VALUE result = rb_hash_new();
+    rb_hash_aset(result, rb_str_new2("ports"), port_descriptions_to_ruby(ports));
+
+    VALUE rb_properties = rb_ary_new();
+    for (size_t i = 0; i < property_names.size(); ++i)
+        rb_ary_push(rb_properties, rb_assoc_new(rb_str_new2(property_names[i].c_str()), rb_str_new2(property_types[i])));
+    rb_hash_aset(result, rb_str_new2("properties"), rb_properties);
+
+    VALUE rb_attributes = rb_ary_new();
+    for (size_t i = 0; i < attribute_names.size(); ++i)
+        rb_ary_push(rb_attributes, rb_assoc_new(rb_str_new2(attribute_names[i].c_str()), rb_str_new2(attribute_types[i])));
+    rb_hash_aset(result, rb_str_new2("attributes"), rb_attributes);
+
+    VALUE rb_operations = rb_ary_new();
+    for (unsigned int i = 0; i != operations->length(); ++i)
+    {
+        #if RTT_VERSION_GTE(2,8,99)
+            rb_ary_push(rb_operations, rb_str_new2(operations[i].name));
+        #else
+            rb_ary_push(rb_operations, rb_str_new2(operations[i]));
+        #endif
+    }
+    rb_hash_aset(result, rb_str_new2("operations"), rb_operations);
+    return result;
+}
+
+/* Returns the whole interface of the task in two rounds of concurrent calls
+ *
+ * The first round gets the ports with their types, and the names of the
+ * properties, attributes and operations. The second one the types of the
+ * properties and attributes
+ *
+ * The result is a hash of the form
+ *
+ *   'ports' => [[name, input_port?, type_name], ...],
+ *   'properties' => [[name, type_name], ...],
+ *   'attributes' => [[name, type_name], ...],
+ *   'operations' => [name, ...]
+ */
+static VALUE task_context_describe(VALUE self)
+{
+    RTaskContext& context = get_wrapped<RTaskContext>(self);
+
+    VALUE exception_class = Qnil;
+    std::string exception_message;
+    VALUE result = describe_task(context, exception_class, exception_message);
+    if (RTEST(exception_class))
+        rb_raise(exception_class, "%s", exception_message.c_str());
+    return result;
+}
+
+/* Returns the description of all the ports of the task in a single call, as
+ * an array of [name, input_port?, type_name]
+ */
+static VALUE task_context_port_descriptions(VALUE self)
+{
+    RTaskContext& context = get_wrapped<RTaskContext>(self);
+    CDataFlowInterface::CPortDescriptions_var ports =
+        corba_blocking_fct_call_with_result(bind(&_objref_CDataFlowInterface::getPortDescriptions,(_objref_CDataFlowInterface*)context.dataFlow()));
+    return port_descriptions_to_ruby(ports.in());
+}
+
 static VALUE task_context_port_names(VALUE self)
 {
     VALUE result = rb_ary_new();
     RTaskContext& context = get_wrapped<RTaskContext>(self);
     RTT::corba::CDataFlowInterface::CPortNames_var ports =
-        corba_blocking_fct_call_with_result(bind(&_objref_CDataFlowInterface::getPorts,(_objref_CDataFlowInterface*)context.ports));
+        corba_blocking_fct_call_with_result(bind(&_objref_CDataFlowInterface::getPorts,(_objref_CDataFlowInterface*)context.dataFlow()));
 
     for (unsigned int i = 0; i < ports->length(); ++i)
         rb_ary_push(result, rb_str_new2(ports[i]));
@@ -335,10 +653,82 @@ static VALUE task_context_port_names(VALUE self)
 //
 // See Orocos own documentation for their meaning
 ///
+namespace
+{
+    /** A state read run with corba_cancellable_call */
+    struct StateQuery
+    {
+        CTaskContext_var task;
+        CTaskState state;
+
+        void run() { state = task->getTaskState(); }
+    };
+}
+
 static VALUE task_context_state(VALUE task)
 {
     RTaskContext& context = get_wrapped<RTaskContext>(task);
-    return INT2FIX(corba_blocking_fct_call_with_result(boost::bind(&_objref_CTaskContext::getTaskState,(CTaskContext_ptr)context.task)));
+    if (!corba_thread_calls_cancellable())
+        return INT2FIX(corba_blocking_fct_call_with_result(boost::bind(&_objref_CTaskContext::getTaskState,(CTaskContext_ptr)context.task)));
+
+    CTaskState state;
+    CORBACallStatus status;
+    {
+        boost::shared_ptr<StateQuery> query(new StateQuery);
+        query->task = CTaskContext::_duplicate(context.task);
+        status = corba_cancellable_call(boost::bind(&StateQuery::run, query));
+        state = query->state;
+    }
+    if (status.failed())
+        rb_raise(status.exception_class, "%s", status.exception_message.c_str());
+    return INT2FIX(state);
+}
+
+// Sets the timeout of the CORBA calls made on this task, in milliseconds
+//
+// The references to the remote task are shared between all the TaskContext
+// objects of the same IOR, so the timeout applies to all of them
+static VALUE task_context_set_call_timeout(VALUE task, VALUE timeout)
+{
+    RTaskContext& context = get_wrapped<RTaskContext>(task);
+    context.setCallTimeout(NUM2ULONG(timeout));
+    return Qnil;
+}
+
+// Reads the state of all the given tasks concurrently
+//
+// Returns an array that contains, for each task, either its state or the
+// exception raised while reading it
+static VALUE task_context_states(VALUE klass, VALUE tasks)
+{
+    Check_Type(tasks, T_ARRAY);
+    // Validate all the elements before any C++ object gets created, as
+    // get_wrapped raises on invalid objects
+    for (long i = 0; i < RARRAY_LEN(tasks); ++i)
+        get_wrapped<RTaskContext>(rb_ary_entry(tasks, i));
+
+    std::vector< boost::function<CTaskState()> > calls;
+    for (long i = 0; i < RARRAY_LEN(tasks); ++i)
+    {
+        RTaskContext& context = get_wrapped<RTaskContext>(rb_ary_entry(tasks, i));
+        calls.push_back(boost::bind(&_objref_CTaskContext::getTaskState, (CTaskContext_ptr)context.task));
+    }
+
+    std::vector<CTaskState> states;
+    std::vector<CORBACallStatus> status;
+    corba_blocking_multi_call(calls, states, status);
+
+    VALUE result = rb_ary_new();
+    for (size_t i = 0; i < states.size(); ++i)
+    {
+        if (status[i].failed())
+            rb_ary_push(result, rb_exc_new(status[i].exception_class,
+                        status[i].exception_message.c_str(),
+                        status[i].exception_message.size()));
+        else
+            rb_ary_push(result, INT2FIX(states[i]));
+    }
+    return result;
 }
 
 static VALUE call_checked_state_change(VALUE task, char const* msg, bool (RTT::corba::_objref_CTaskContext::*m)())
@@ -389,7 +779,7 @@ static VALUE port_connected_p(VALUE self)
 {
     RTaskContext* task; VALUE name;
     tie(task, tuples::ignore, name) = getPortReference(self);
-    bool result = corba_blocking_fct_call_with_result(bind(&_objref_CDataFlowInterface::isConnected,(_objref_CDataFlowInterface*)task->ports,
+    bool result = corba_blocking_fct_call_with_result(bind(&_objref_CDataFlowInterface::isConnected,(_objref_CDataFlowInterface*)task->dataFlow(),
                                                       StringValuePtr(name)));
     return result ? Qtrue : Qfalse;
 }
@@ -445,18 +835,148 @@ static VALUE do_port_connect_to(VALUE routput_port, VALUE rinput_port, VALUE opt
     tie(in_task, tuples::ignore, in_name) = getPortReference(rinput_port);
 
     RTT::corba::CConnPolicy policy = policyFromHash(options);
-    bool result = corba_blocking_fct_call_with_result(bind(&_objref_CDataFlowInterface::createConnection,(_objref_CDataFlowInterface*)out_task->ports,
-                StringValuePtr(out_name),in_task->ports,StringValuePtr(in_name),policy));
+    bool result = corba_blocking_fct_call_with_result(bind(&_objref_CDataFlowInterface::createConnection,(_objref_CDataFlowInterface*)out_task->dataFlow(),
+                StringValuePtr(out_name),in_task->dataFlow(),StringValuePtr(in_name),policy));
     if(!result)
         rb_raise(eConnectionFailed, "failed to connect ports");
     return Qnil;
 }
 
+namespace
+{
+    /** A connection created or removed by do_port_connect_all and
+     * do_port_disconnect_pairs
+     */
+    struct ConnectionCall
+    {
+        typedef int result_type;
+
+        _objref_CDataFlowInterface* out;
+        std::string out_name;
+        _objref_CDataFlowInterface* in;
+        std::string in_name;
+        RTT::corba::CConnPolicy policy;
+        bool disconnect;
+
+        int operator()()
+        {
+            if (disconnect)
+                return out->removeConnection(out_name.c_str(), in, in_name.c_str());
+            else
+                return out->createConnection(out_name.c_str(), in, in_name.c_str(), policy);
+        }
+    };
+
+    /** Fills +call+ with the references of the given ports
+     *
+     * It is filled in place, so that no C++ temporary is left behind if the
+     * resolution of the ports raises
+     */
+    void connectionCallFromPorts(ConnectionCall& call, VALUE routput_port, VALUE rinput_port)
+    {
+        RTaskContext* out_task; VALUE out_name;
+        tie(out_task, tuples::ignore, out_name) = getPortReference(routput_port);
+        RTaskContext* in_task; VALUE in_name;
+        tie(in_task, tuples::ignore, in_name) = getPortReference(rinput_port);
+        call.out = out_task->dataFlow();
+        call.out_name = StringValuePtr(out_name);
+        call.in = in_task->dataFlow();
+        call.in_name = StringValuePtr(in_name);
+    }
+
+    /** Arguments of fillConnectionCalls, passed through rb_protect */
+    struct ConnectionCallsFill
+    {
+        VALUE connections;
+        bool disconnect;
+        std::vector<ConnectionCall>* calls;
+    };
+
+    VALUE fillConnectionCalls(VALUE _fill)
+    {
+        ConnectionCallsFill& fill = *reinterpret_cast<ConnectionCallsFill*>(_fill);
+        for (long i = 0; i < RARRAY_LEN(fill.connections); ++i)
+        {
+            VALUE connection = rb_ary_entry(fill.connections, i);
+            fill.calls->push_back(ConnectionCall());
+            ConnectionCall& call = fill.calls->back();
+            call.disconnect = fill.disconnect;
+            connectionCallFromPorts(call,
+                    rb_ary_entry(connection, 0), rb_ary_entry(connection, 1));
+            if (!fill.disconnect)
+                call.policy = policyFromHash(rb_ary_entry(connection, 2));
+        }
+        return Qnil;
+    }
+
+    VALUE connectionCallResults(std::vector<ConnectionCall> const& calls, size_t max_concurrency)
+    {
+        std::vector<int> results;
+        std::vector<CORBACallStatus> status;
+        corba_blocking_multi_call(calls, results, status, max_concurrency);
+
+        VALUE result = rb_ary_new();
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            if (status[i].failed())
+                rb_ary_push(result, rb_exc_new(status[i].exception_class,
+                            status[i].exception_message.c_str(),
+                            status[i].exception_message.size()));
+            else
+                rb_ary_push(result, results[i] ? Qtrue : Qfalse);
+        }
+        return result;
+    }
+
+    /** Builds the calls for +connections+ and runs them concurrently
+     *
+     * The calls are built under rb_protect, and the exception raised while
+     * resolving the ports, if any, is re-raised once they are destroyed
+     */
+    VALUE runConnectionCalls(VALUE connections, bool disconnect, size_t max_concurrency)
+    {
+        VALUE result = Qnil;
+        int state = 0;
+        {
+            std::vector<ConnectionCall> calls;
+            ConnectionCallsFill fill = { connections, disconnect, &calls };
+            rb_protect(fillConnectionCalls, reinterpret_cast<VALUE>(&fill), &state);
+            if (!state)
+                result = connectionCallResults(calls, max_concurrency);
+        }
+        if (state)
+            rb_jump_tag(state);
+        return result;
+    }
+}
+
+/* Creates the given connections concurrently. +connections+ is an array of
+ * [output_port, input_port, policy] tuples. Sanity checks are done in Ruby.
+ *
+ * Returns an array that contains, for each connection, either the value
+ * returned by createConnection or the exception raised while creating it
+ */
+static VALUE do_port_connect_all(VALUE klass, VALUE connections, VALUE max_concurrency)
+{
+    return runConnectionCalls(connections, false, NUM2INT(max_concurrency));
+}
+
+/* Removes the connections between the given [output_port, input_port] pairs
+ * concurrently
+ *
+ * Returns an array that contains, for each pair, either the value returned by
+ * removeConnection or the exception raised while removing it
+ */
+static VALUE do_port_disconnect_pairs(VALUE klass, VALUE pairs, VALUE max_concurrency)
+{
+    return runConnectionCalls(pairs, true, NUM2INT(max_concurrency));
+}
+
 static VALUE do_port_disconnect_all(VALUE port)
 {
     RTaskContext* task; VALUE name;
     tie(task, tuples::ignore, name) = getPortReference(port);
-    corba_blocking_fct_call(bind(&_objref_CDataFlowInterface::disconnectPort,(_objref_CDataFlowInterface*)task->ports,
+    corba_blocking_fct_call(bind(&_objref_CDataFlowInterface::disconnectPort,(_objref_CDataFlowInterface*)task->dataFlow(),
                             StringValuePtr(name)));
     return Qnil;
 }
@@ -467,8 +987,8 @@ static VALUE do_port_disconnect_from(VALUE self, VALUE other)
     tie(self_task, tuples::ignore, self_name) = getPortReference(self);
     RTaskContext* other_task; VALUE other_name;
     tie(other_task, tuples::ignore, other_name) = getPortReference(other);
-    bool result = corba_blocking_fct_call_with_result(bind(&_objref_CDataFlowInterface::removeConnection,(_objref_CDataFlowInterface*)self_task->ports,
-                StringValuePtr(self_name),other_task->ports,StringValuePtr(other_name)));
+    bool result = corba_blocking_fct_call_with_result(bind(&_objref_CDataFlowInterface::removeConnection,(_objref_CDataFlowInterface*)self_task->dataFlow(),
+                StringValuePtr(self_name),other_task->dataFlow(),StringValuePtr(other_name)));
     return result ? Qtrue : Qfalse;
 }
 
@@ -478,7 +998,7 @@ static VALUE do_port_create_stream(VALUE rport, VALUE _policy)
     tie(task, tuples::ignore, name) = getPortReference(rport);
 
     RTT::corba::CConnPolicy policy = policyFromHash(_policy);
-    bool result = corba_blocking_fct_call_with_result(bind(&_objref_CDataFlowInterface::createStream,(_objref_CDataFlowInterface*)task->ports,
+    bool result = corba_blocking_fct_call_with_result(bind(&_objref_CDataFlowInterface::createStream,(_objref_CDataFlowInterface*)task->dataFlow(),
                 StringValuePtr(name),policy));
     if(!result)
         rb_raise(eConnectionFailed, "failed to create stream");
@@ -490,7 +1010,7 @@ static VALUE do_port_remove_stream(VALUE rport, VALUE stream_name)
     RTaskContext* task; VALUE name;
     tie(task, tuples::ignore, name) = getPortReference(rport);
 
-    corba_blocking_fct_call(bind(&_objref_CDataFlowInterface::removeStream,(_objref_CDataFlowInterface*)task->ports,
+    corba_blocking_fct_call(bind(&_objref_CDataFlowInterface::removeStream,(_objref_CDataFlowInterface*)task->dataFlow(),
                             StringValuePtr(name),StringValuePtr(stream_name)));
     return Qnil;
 }
@@ -526,6 +1046,7 @@ static VALUE orocos_load_standard_typekits(VALUE mod)
     RTT::types::TypekitRepository::Import(new RTT::mqueue::MQLibPlugin);
 #endif
     //TODO loadCorbaLib();
+    refresh_type_bindings();
     return Qnil;
 }
 
@@ -533,7 +1054,9 @@ static VALUE orocos_load_rtt_typekit(VALUE orocos, VALUE path)
 {
     try
     {
-        return RTT::plugin::PluginLoader::Instance()->loadLibrary(StringValuePtr(path)) ? Qtrue : Qfalse;
+        bool loaded = RTT::plugin::PluginLoader::Instance()->loadLibrary(StringValuePtr(path));
+        refresh_type_bindings();
+        return loaded ? Qtrue : Qfalse;
     }
     catch(std::runtime_error e)
     {
@@ -545,7 +1068,9 @@ static VALUE orocos_load_rtt_plugin(VALUE orocos, VALUE path)
 {
     try
     {
-        return RTT::plugin::PluginLoader::Instance()->loadLibrary(StringValuePtr(path)) ? Qtrue : Qfalse;
+        bool loaded = RTT::plugin::PluginLoader::Instance()->loadLibrary(StringValuePtr(path));
+        refresh_type_bindings();
+        return loaded ? Qtrue : Qfalse;
     }
     catch(std::runtime_error e)
     {
@@ -613,6 +1138,8 @@ extern "C" void Init_rorocos()
 {
     mOrocos = rb_define_module("Orocos");
     mCORBA  = rb_define_module_under(mOrocos, "CORBA");
+    id_iv_task = rb_intern("@task");
+    id_iv_name = rb_intern("@name");
     eComError    = rb_define_class_under(mOrocos, "ComError", rb_eRuntimeError);
     eCORBA    = rb_define_class_under(mOrocos, "CORBAError", rb_eRuntimeError);
     eCORBAComError = rb_define_class_under(mCORBA, "ComError", eComError);
@@ -624,6 +1151,7 @@ extern "C" void Init_rorocos()
     rb_define_singleton_method(mOrocos, "load_rtt_typekit", RUBY_METHOD_FUNC(orocos_load_rtt_typekit), 1);
     rb_define_singleton_method(mOrocos, "registered_type?", RUBY_METHOD_FUNC(orocos_registered_type_p), 1);
     rb_define_singleton_method(mOrocos, "do_typelib_type_for", RUBY_METHOD_FUNC(orocos_typelib_type_for), 1);
+    rb_define_singleton_method(mOrocos, "do_type_binding", RUBY_METHOD_FUNC(orocos_type_binding), 1);
     rb_define_singleton_method(mOrocos, "no_blocking_calls_in_thread=", RUBY_METHOD_FUNC(orocos_no_blocking_calls_in_thread_set), 1);
     rb_define_singleton_method(mOrocos, "no_blocking_calls_in_thread", RUBY_METHOD_FUNC(orocos_no_blocking_calls_in_thread_get), 0);
 
@@ -638,6 +1166,7 @@ extern "C" void Init_rorocos()
     rb_const_set(mOrocos, rb_intern("TRANSPORT_CORBA"), INT2FIX(ORO_CORBA_PROTOCOL_ID));
 
     cTaskContext = rb_define_class_under(mOrocos, "TaskContext", cTaskContextBase);
+    cTypeBinding = rb_define_class_under(mOrocos, "TypeBinding", rb_cObject);
 
 #ifdef HAS_MQUEUE
     VALUE mMQueue  = rb_define_module_under(mOrocos, "MQueue");
@@ -658,6 +1187,8 @@ extern "C" void Init_rorocos()
     rb_define_method(cTaskContext, "do_real_name", RUBY_METHOD_FUNC(task_context_real_name), 0);
     rb_define_method(cTaskContext, "==", RUBY_METHOD_FUNC(task_context_equal_p), 1);
     rb_define_method(cTaskContext, "do_state", RUBY_METHOD_FUNC(task_context_state), 0);
+    rb_define_method(cTaskContext, "do_call_timeout", RUBY_METHOD_FUNC(task_context_set_call_timeout), 1);
+    rb_define_singleton_method(cTaskContext, "do_states", RUBY_METHOD_FUNC(task_context_states), 1);
     rb_define_method(cTaskContext, "do_configure", RUBY_METHOD_FUNC(task_context_configure), 0);
     rb_define_method(cTaskContext, "do_start", RUBY_METHOD_FUNC(task_context_start), 0);
     rb_define_method(cTaskContext, "do_reset_exception", RUBY_METHOD_FUNC(task_context_reset_exception), 0);
@@ -670,8 +1201,9 @@ extern "C" void Init_rorocos()
     rb_define_method(cTaskContext, "do_attribute_names", RUBY_METHOD_FUNC(task_context_attribute_names), 0);
     rb_define_method(cTaskContext, "do_property_names", RUBY_METHOD_FUNC(task_context_property_names), 0);
     rb_define_method(cTaskContext, "do_operation_names", RUBY_METHOD_FUNC(task_context_operation_names), 0);
-    rb_define_method(cTaskContext, "do_port", RUBY_METHOD_FUNC(task_context_do_port), 2);
     rb_define_method(cTaskContext, "do_port_names", RUBY_METHOD_FUNC(task_context_port_names), 0);
+    rb_define_method(cTaskContext, "do_port_descriptions", RUBY_METHOD_FUNC(task_context_port_descriptions), 0);
+    rb_define_method(cTaskContext, "do_describe", RUBY_METHOD_FUNC(task_context_describe), 0);
 
     rb_define_method(cPort, "connected?", RUBY_METHOD_FUNC(port_connected_p), 0);
     rb_define_method(cPort, "do_disconnect_from", RUBY_METHOD_FUNC(do_port_disconnect_from), 1);
@@ -679,6 +1211,8 @@ extern "C" void Init_rorocos()
     rb_define_method(cPort, "do_create_stream", RUBY_METHOD_FUNC(do_port_create_stream), 1);
     rb_define_method(cPort, "do_remove_stream", RUBY_METHOD_FUNC(do_port_remove_stream), 1);
     rb_define_method(cOutputPort, "do_connect_to", RUBY_METHOD_FUNC(do_port_connect_to), 2);
+    rb_define_singleton_method(cOutputPort, "do_connect_all", RUBY_METHOD_FUNC(do_port_connect_all), 2);
+    rb_define_singleton_method(cOutputPort, "do_disconnect_pairs", RUBY_METHOD_FUNC(do_port_disconnect_pairs), 2);
 
     Orocos_init_CORBA();
 #ifdef HAS_ROS
@@ -1,7 +1,9 @@
 #ifndef OROCOS_EXT_RB_ROROCOS_HH
 #define OROCOS_EXT_RB_ROROCOS_HH
 
+#include <vector>
 #include <boost/tuple/tuple.hpp>
+#include <boost/thread/mutex.hpp>
 #include <rtt/typelib/TypelibMarshallerBase.hpp>
 #include <rtt/transports/corba/CorbaTypeTransporter.hpp>
 
@@ -26,13 +28,107 @@ namespace RTT
 
 struct RTaskContext;
 
+/** The RTT type information and transports resolved for a given type
+ *
+ * Bindings are resolved once by get_type_binding and then passed around by
+ * the Ruby objects (ports, properties, operations) so that the per-sample
+ * read and write paths do not have to look them up again
+ */
+struct RTypeBinding
+{
+    RTT::types::TypeInfo* type_info;
+    RTT::corba::CorbaTypeTransporter* corba_transport;
+    orogen_transports::TypelibMarshallerBase* typelib_transport;
+    /** True if the Ruby-side value can be used as-is by the RTT, i.e. if
+     * there is no typelib transport or if the type is plain
+     */
+    bool plain;
+};
+
+/** Pool of typelib marshaller handles
+ *
+ * Converting an opaque type requires a handle, which holds the intermediate
+ * orocos sample. The pool keeps the handles alive between calls instead of
+ * creating and deleting one per sample. Handles acquired by concurrent callers
+ * are created on demand, and at most +max_size+ idle handles are kept.
+ *
+ * The transport is given by the caller on each acquire and release, as it is
+ * taken from the binding at the time of the call. The idle handles are
+ * discarded if it changes.
+ */
+class TypelibHandlePool
+{
+public:
+    typedef orogen_transports::TypelibMarshallerBase::Handle Handle;
+
+    TypelibHandlePool(size_t max_size = 4);
+    ~TypelibHandlePool();
+
+    Handle* acquire(orogen_transports::TypelibMarshallerBase* transport);
+    void release(orogen_transports::TypelibMarshallerBase* transport, Handle* handle);
+
+private:
+    orogen_transports::TypelibMarshallerBase* transport;
+    std::vector<Handle*> handles;
+    size_t max_size;
+    boost::mutex mutex;
+};
+
+/** The object wrapped by Orocos::TypeBinding
+ *
+ * Each Ruby object that resolves a binding (port, property, operation) gets
+ * its own, and therefore its own pool of marshaller handles
+ */
+struct RTypeBindingObject
+{
+    RTypeBinding const& binding;
+    TypelibHandlePool handles;
+
+    RTypeBindingObject(RTypeBinding const& binding)
+        : binding(binding) {}
+};
+
+/** Scoped access to a typelib marshaller handle
+ *
+ * The handle is taken from +pool+ if one is given, and created for this
+ * scope only otherwise
+ */
+class TypelibHandle
+{
+public:
+    TypelibHandle(RTypeBinding const& binding, TypelibHandlePool* pool);
+    ~TypelibHandle();
+
+    TypelibHandlePool::Handle* get() const { return handle; }
+
+private:
+    orogen_transports::TypelibMarshallerBase* transport;
+    TypelibHandlePool* pool;
+    TypelibHandlePool::Handle* handle;
+};
+
 extern VALUE task_context_create(int argc, VALUE *argv,VALUE klass);
 
 extern RTT::types::TypeInfo* get_type_info(std::string const& name, bool do_check = true);
+extern RTypeBinding const& get_type_binding(std::string const& name);
+extern RTypeBinding const& get_type_binding(VALUE binding_or_name);
+extern TypelibHandlePool* get_typelib_handle_pool(VALUE binding_or_name);
+
+/** Updates +dest+ from the orocos sample held by +handle+
+ *
+ * +dest+ must be the value that has been given to setTypelibSample on the
+ * handle. The marshaller then converts the orocos sample directly into its
+ * buffer, and the value is copied only if the marshaller used its own
+ */
+extern void refresh_typelib_value(orogen_transports::TypelibMarshallerBase* transport,
+        TypelibHandlePool::Handle* handle, Typelib::Value dest);
 extern orogen_transports::TypelibMarshallerBase* get_typelib_transport(RTT::types::TypeInfo* type, bool do_check = true);
 extern orogen_transports::TypelibMarshallerBase* get_typelib_transport(std::string const& name, bool do_check = true);
 extern RTT::corba::CorbaTypeTransporter* get_corba_transport(RTT::types::TypeInfo* type, bool do_check = true);
 extern RTT::corba::CorbaTypeTransporter* get_corba_transport(std::string const& name, bool do_check = true);
+/** Returns the task context, the Ruby task object and the name of a port
+ * object
+ */
 extern boost::tuple<RTaskContext*, VALUE, VALUE> getPortReference(VALUE port);
 
 extern VALUE corbaAccess;
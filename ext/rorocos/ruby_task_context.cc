@@ -6,11 +6,18 @@
 #include <rtt/base/PortInterface.hpp>
 #include <rtt/transports/corba/TransportPlugin.hpp>
 #include <rtt/internal/ConnFactory.hpp>
+#include <rtt/internal/Reference.hpp>
 
 #include <rtt/OutputPort.hpp>
+#include <rtt/InputPort.hpp>
+#include <rtt/Handle.hpp>
 #include <rtt/base/InputPortInterface.hpp>
+#include <rtt/base/BufferLockFree.hpp>
 
 #include <typelib_ruby.hh>
+#include <typelib/typemodel.hh>
+#include <typelib/value_ops.hh>
+#include <typelib/memory_layout.hh>
 #include <rtt/transports/corba/CorbaLib.hpp>
 
 #include <rtt/TaskContext.hpp>
@@ -18,6 +25,15 @@
 #include <rtt/transports/corba/CorbaDispatcher.hpp>
 #include "rblocking_call.h"
 
+#include <map>
+#include <set>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+
 #ifdef HAS_GETTID
 #include <sys/syscall.h>
 #endif
@@ -26,6 +42,11 @@ static VALUE cRubyTaskContext;
 static VALUE cLocalTaskContext;
 static VALUE cLocalOutputPort;
 static VALUE cLocalInputPort;
+static VALUE cStateMultiplexer;
+static VALUE cFlightRecorder;
+static VALUE cInputPortGroup;
+static VALUE cNewDataWaiter;
+static VALUE cFieldProjection;
 
 struct LocalTaskContext : public RTT::TaskContext
 {
@@ -334,19 +355,19 @@ static VALUE local_task_context_create_attribute(VALUE _task, VALUE _klass, VALU
     return ruby_attribute;
 }
 
-static VALUE local_input_port_read(VALUE _local_port, VALUE type_name, VALUE rb_typelib_value, VALUE copy_old_data, VALUE blocking_read)
+static VALUE local_input_port_read(VALUE _local_port, VALUE type_binding, VALUE rb_typelib_value, VALUE copy_old_data, VALUE blocking_read)
 {
     RTT::base::InputPortInterface& local_port = get_wrapped<RTT::base::InputPortInterface>(_local_port);
     Typelib::Value value = typelib_get(rb_typelib_value);
 
-    RTT::types::TypeInfo* ti = get_type_info(StringValuePtr(type_name));
+    RTypeBinding const& binding = get_type_binding(type_binding);
     orogen_transports::TypelibMarshallerBase* typelib_transport =
-        get_typelib_transport(ti, false);
+        binding.typelib_transport;
 
-    if (!typelib_transport || typelib_transport->isPlainTypelibType())
+    if (binding.plain)
     {
         RTT::base::DataSourceBase::shared_ptr ds =
-            ti->buildReference(value.getData());
+            binding.type_info->buildReference(value.getData());
         RTT::FlowStatus did_read;
         if (RTEST(blocking_read))
             did_read = blocking_fct_call_with_result(boost::bind(&RTT::base::InputPortInterface::read,&local_port,ds,RTEST(copy_old_data)));
@@ -362,13 +383,12 @@ static VALUE local_input_port_read(VALUE _local_port, VALUE type_name, VALUE rb_
     }
     else
     {
-        orogen_transports::TypelibMarshallerBase::Handle* handle =
-            typelib_transport->createHandle();
+        TypelibHandle handle(binding, get_typelib_handle_pool(type_binding));
         // Set the typelib sample using the value passed from ruby to avoid
         // unnecessary convertions. Don't touch the orocos sample though.
-        typelib_transport->setTypelibSample(handle, value, false);
+        typelib_transport->setTypelibSample(handle.get(), value, false);
         RTT::base::DataSourceBase::shared_ptr ds =
-            typelib_transport->getDataSource(handle);
+            typelib_transport->getDataSource(handle.get());
         RTT::FlowStatus did_read;
         if (RTEST(blocking_read))
             did_read = blocking_fct_call_with_result(boost::bind(&RTT::base::InputPortInterface::read,&local_port,ds,RTEST(copy_old_data)));
@@ -376,12 +396,8 @@ static VALUE local_input_port_read(VALUE _local_port, VALUE type_name, VALUE rb_
             did_read = local_port.read(ds, RTEST(copy_old_data));
        
         if (did_read == RTT::NewData || (did_read == RTT::OldData && RTEST(copy_old_data)))
-        {
-            typelib_transport->refreshTypelibSample(handle);
-            Typelib::copy(value, Typelib::Value(typelib_transport->getTypelibSample(handle), value.getType()));
-        }
+            refresh_typelib_value(typelib_transport, handle.get(), value);
 
-        typelib_transport->deleteHandle(handle);
         switch(did_read)
         {
             case RTT::NoData:  return Qfalse;
@@ -391,6 +407,63 @@ static VALUE local_input_port_read(VALUE _local_port, VALUE type_name, VALUE rb_
     }
     return Qnil; // Never reached
 }
+/** Reads new samples from +port+ into +samples+ until either the port has no
+ * new data or all samples have been filled
+ *
+ * @return the number of samples read
+ */
+static int local_input_port_drain(RTT::base::InputPortInterface* port,
+        RTypeBinding const* binding, TypelibHandlePool::Handle* handle,
+        std::vector<Typelib::Value> const* samples)
+{
+    orogen_transports::TypelibMarshallerBase* typelib_transport =
+        binding->typelib_transport;
+
+    RTT::base::DataSourceBase::shared_ptr ds;
+    if (!binding->plain)
+        ds = typelib_transport->getDataSource(handle);
+
+    int count = 0;
+    for (; count < static_cast<int>(samples->size()); ++count)
+    {
+        Typelib::Value value = (*samples)[count];
+        if (binding->plain)
+            ds = binding->type_info->buildReference(value.getData());
+        else
+            typelib_transport->setTypelibSample(handle, value, false);
+
+        if (port->read(ds, false) != RTT::NewData)
+            break;
+
+        if (!binding->plain)
+            refresh_typelib_value(typelib_transport, handle, value);
+    }
+    return count;
+}
+
+static VALUE local_input_port_read_batch(VALUE _local_port, VALUE type_binding, VALUE rb_samples, VALUE blocking_read)
+{
+    RTT::base::InputPortInterface& local_port = get_wrapped<RTT::base::InputPortInterface>(_local_port);
+
+    std::vector<Typelib::Value> samples;
+    samples.reserve(RARRAY_LEN(rb_samples));
+    for (int i = 0; i < RARRAY_LEN(rb_samples); ++i)
+        samples.push_back(typelib_get(rb_ary_entry(rb_samples, i)));
+
+    RTypeBinding const& binding = get_type_binding(type_binding);
+    std::auto_ptr<TypelibHandle> handle;
+    if (!binding.plain)
+        handle.reset(new TypelibHandle(binding, get_typelib_handle_pool(type_binding)));
+
+    TypelibHandlePool::Handle* typelib_handle = handle.get() ? handle->get() : 0;
+    int count;
+    if (RTEST(blocking_read))
+        count = blocking_fct_call_with_result(boost::bind(&local_input_port_drain,&local_port,&binding,typelib_handle,&samples));
+    else
+        count = local_input_port_drain(&local_port, &binding, typelib_handle, &samples);
+    return INT2FIX(count);
+}
+
 static VALUE local_input_port_clear(VALUE _local_port)
 {
     RTT::base::InputPortInterface& local_port = get_wrapped<RTT::base::InputPortInterface>(_local_port);
@@ -398,39 +471,1156 @@ static VALUE local_input_port_clear(VALUE _local_port)
     return Qnil;
 }
 
-static VALUE local_output_port_write(VALUE _local_port, VALUE type_name, VALUE rb_typelib_value)
+static VALUE local_output_port_write(VALUE _local_port, VALUE type_binding, VALUE rb_typelib_value)
 {
     RTT::base::OutputPortInterface& local_port = get_wrapped<RTT::base::OutputPortInterface>(_local_port);
     Typelib::Value value = typelib_get(rb_typelib_value);
 
-    orogen_transports::TypelibMarshallerBase* transport = 0;
-    RTT::types::TypeInfo* ti = get_type_info(StringValuePtr(type_name));
-    if (ti && ti->hasProtocol(orogen_transports::TYPELIB_MARSHALLER_ID))
-    {
-        transport =
-            dynamic_cast<orogen_transports::TypelibMarshallerBase*>(ti->getProtocol(orogen_transports::TYPELIB_MARSHALLER_ID));
-    }
+    RTypeBinding const& binding = get_type_binding(type_binding);
+    orogen_transports::TypelibMarshallerBase* transport =
+        binding.typelib_transport;
 
-    if (!transport)
+    if (binding.plain)
     {
         RTT::base::DataSourceBase::shared_ptr ds =
-            ti->buildReference(value.getData());
+            binding.type_info->buildReference(value.getData());
         local_port.write(ds);
     }
     else
     {
-        orogen_transports::TypelibMarshallerBase::Handle* handle =
-            transport->createHandle();
-
-        transport->setTypelibSample(handle, static_cast<uint8_t*>(value.getData()));
+        TypelibHandle handle(binding, get_typelib_handle_pool(type_binding));
+        transport->setTypelibSample(handle.get(), static_cast<uint8_t*>(value.getData()));
         RTT::base::DataSourceBase::shared_ptr ds =
-            transport->getDataSource(handle);
+            transport->getDataSource(handle.get());
         local_port.write(ds);
-        transport->deleteHandle(handle);
     }
     return local_port.connected() ? Qtrue : Qfalse;
 }
 
+static VALUE local_output_port_write_batch(VALUE _local_port, VALUE type_binding, VALUE rb_samples)
+{
+    RTT::base::OutputPortInterface& local_port = get_wrapped<RTT::base::OutputPortInterface>(_local_port);
+
+    std::vector<Typelib::Value> samples;
+    samples.reserve(RARRAY_LEN(rb_samples));
+    for (int i = 0; i < RARRAY_LEN(rb_samples); ++i)
+        samples.push_back(typelib_get(rb_ary_entry(rb_samples, i)));
+    if (samples.empty())
+        return local_port.connected() ? Qtrue : Qfalse;
+
+    RTypeBinding const& binding = get_type_binding(type_binding);
+    orogen_transports::TypelibMarshallerBase* transport =
+        binding.typelib_transport;
+
+    if (binding.plain)
+    {
+        // Build a single reference data source and retarget it to each
+        // sample in turn
+        RTT::base::DataSourceBase::shared_ptr ds =
+            binding.type_info->buildReference(samples.front().getData());
+        RTT::internal::Reference* ref =
+            dynamic_cast<RTT::internal::Reference*>(ds.get());
+        for (size_t i = 0; i < samples.size(); ++i)
+        {
+            if (!ref)
+                ds = binding.type_info->buildReference(samples[i].getData());
+            else if (i != 0)
+                ref->setReference(samples[i].getData());
+            local_port.write(ds);
+        }
+    }
+    else
+    {
+        TypelibHandle handle(binding, get_typelib_handle_pool(type_binding));
+        RTT::base::DataSourceBase::shared_ptr ds =
+            transport->getDataSource(handle.get());
+        for (size_t i = 0; i < samples.size(); ++i)
+        {
+            transport->setTypelibSample(handle.get(), static_cast<uint8_t*>(samples[i].getData()));
+            local_port.write(ds);
+        }
+    }
+    return local_port.connected() ? Qtrue : Qfalse;
+}
+
+/** Monitors the state port of many tasks from a single thread
+ *
+ * Each monitored task gets an input port on the local task context. The
+ * ports' new-data callbacks only flag the port, and the multiplexer thread
+ * then reads the flagged ports and queues one record per state change. The
+ * records are stored in a lock-free buffer that Ruby drains in batches, and
+ * Ruby gets notified through a pipe
+ *
+ * As with InputPortGroup, the callbacks are bound to a reference-counted
+ * state that is flagged as closed when the multiplexer gets destroyed. The
+ * state's mutex only protects the set of watched ports and the
+ * notifications, so that the callbacks never wait on the thread reading the
+ * ports
+ */
+class StateMultiplexer
+{
+public:
+    struct Record
+    {
+        long id;
+        boost::int32_t state;
+        timespec time;
+    };
+
+    /** +task+ is the Ruby object that wraps the local task context. It is
+     * resolved with local_task_context() each time it is needed, so that
+     * using the multiplexer after the task got disposed raises instead of
+     * accessing a deleted object
+     */
+    StateMultiplexer(VALUE task, size_t capacity)
+        : task(task)
+        , state(new State(capacity))
+    {
+        thread = boost::thread(boost::bind(&StateMultiplexer::run, state));
+    }
+
+    ~StateMultiplexer()
+    {
+        {
+            boost::mutex::scoped_lock lock(state->mutex);
+            state->closed = true;
+        }
+        state->cond.notify_all();
+        thread.join();
+
+        while (!state->entries.empty())
+            unwatch(state->entries.begin()->first);
+    }
+
+    int wakeupFD() const { return state->wakeup_fds[0]; }
+
+    /** The Ruby object that wraps the local task context */
+    VALUE rubyTask() const { return task; }
+
+    /** Creates on +task+ the input port that will receive the state of the
+     * task identified by +id+
+     */
+    void watch(LocalTaskContext& task, long id, std::string const& port_name)
+    {
+        boost::shared_ptr<Entry> entry(new Entry);
+        entry->port = new RTT::InputPort<boost::int32_t>(port_name);
+        entry->callback = entry->port->getNewDataOnPortEvent()->connect(
+                boost::bind(&StateMultiplexer::newData, state, id));
+        task.ports()->addPort(*entry->port);
+
+        boost::mutex::scoped_lock lock(state->mutex);
+        state->entries[id] = entry;
+    }
+
+    void unwatch(long id)
+    {
+        boost::shared_ptr<Entry> entry;
+        {
+            boost::mutex::scoped_lock lock(state->mutex);
+            std::map< long, boost::shared_ptr<Entry> >::iterator it = state->entries.find(id);
+            if (it == state->entries.end())
+                return;
+            entry = it->second;
+            state->entries.erase(it);
+            state->dirty.erase(id);
+        }
+
+        // The thread might still be reading the port, in which case it
+        // holds a reference on the entry. Wait for it to finish, and let it
+        // know that the port is gone
+        boost::mutex::scoped_lock lock(entry->mutex);
+        entry->removed = true;
+        entry->callback.disconnect();
+        entry->port->disconnect();
+        if (entry->port->getInterface())
+            entry->port->getInterface()->removePort(entry->port->getName());
+    }
+
+    /** Makes the thread read the port of +id+ even if it did not get a
+     * new-data notification, e.g. to get the initial sample of a connection
+     */
+    void poll(long id)
+    { newData(state, id); }
+
+    /** Returns the records queued so far
+     *
+     * The pipe is emptied before popping the records: records queued
+     * in-between then only cause a spurious wakeup, while emptying it
+     * afterwards could consume the notification of records that are still
+     * in the queue
+     */
+    size_t drain(std::vector<Record>& records)
+    {
+        char buffer[64];
+        while (read(state->wakeup_fds[0], buffer, sizeof(buffer)) > 0);
+        state->queue.Pop(records);
+        return records.size();
+    }
+
+    /** The number of records that got dropped because Ruby did not drain
+     * the queue fast enough
+     */
+    size_t droppedCount()
+    {
+        boost::mutex::scoped_lock lock(state->mutex);
+        return state->dropped;
+    }
+
+private:
+    struct Entry
+    {
+        RTT::InputPort<boost::int32_t>* port;
+        RTT::Handle callback;
+
+        // Held while the port is read or removed
+        boost::mutex mutex;
+        bool removed;
+
+        Entry()
+            : port(0)
+            , removed(false) {}
+
+        ~Entry()
+        { delete port; }
+    };
+
+    struct State
+    {
+        RTT::base::BufferLockFree<Record> queue;
+
+        // Protects the fields below
+        boost::mutex mutex;
+        boost::condition_variable cond;
+        bool closed;
+        size_t dropped;
+        std::map< long, boost::shared_ptr<Entry> > entries;
+        std::set<long> dirty;
+
+        int wakeup_fds[2];
+
+        State(size_t capacity)
+            : queue(capacity, Record())
+            , closed(false)
+            , dropped(0)
+        {
+            if (pipe(wakeup_fds) == -1)
+                throw std::runtime_error("cannot create the multiplexer's wakeup pipe");
+            for (int i = 0; i < 2; ++i)
+                fcntl(wakeup_fds[i], F_SETFL, fcntl(wakeup_fds[i], F_GETFL) | O_NONBLOCK);
+        }
+
+        ~State()
+        {
+            close(wakeup_fds[0]);
+            close(wakeup_fds[1]);
+        }
+    };
+
+    static void newData(boost::shared_ptr<State> state, long id)
+    {
+        {
+            boost::mutex::scoped_lock lock(state->mutex);
+            if (state->closed)
+                return;
+            state->dirty.insert(id);
+        }
+        state->cond.notify_all();
+    }
+
+    static void run(boost::shared_ptr<State> state)
+    {
+        std::set<long> ready;
+        std::vector< std::pair< long, boost::shared_ptr<Entry> > > ready_entries;
+        while (true)
+        {
+            {
+                boost::mutex::scoped_lock lock(state->mutex);
+                while (state->dirty.empty() && !state->closed)
+                    state->cond.wait(lock);
+                if (state->closed)
+                    return;
+                ready.swap(state->dirty);
+
+                for (std::set<long>::const_iterator it = ready.begin(); it != ready.end(); ++it)
+                {
+                    std::map< long, boost::shared_ptr<Entry> >::iterator entry = state->entries.find(*it);
+                    if (entry != state->entries.end())
+                        ready_entries.push_back(*entry);
+                }
+                ready.clear();
+            }
+
+            bool queued = false;
+            size_t dropped = 0;
+            for (size_t i = 0; i < ready_entries.size(); ++i)
+            {
+                Entry& entry = *ready_entries[i].second;
+                boost::mutex::scoped_lock lock(entry.mutex);
+                if (entry.removed)
+                    continue;
+
+                Record record;
+                record.id = ready_entries[i].first;
+                while (entry.port->read(record.state, false) == RTT::NewData)
+                {
+                    clock_gettime(CLOCK_REALTIME, &record.time);
+                    if (state->queue.Push(record))
+                        queued = true;
+                    else
+                        ++dropped;
+                }
+            }
+            ready_entries.clear();
+
+            if (dropped)
+            {
+                boost::mutex::scoped_lock lock(state->mutex);
+                state->dropped += dropped;
+            }
+            if (queued)
+            {
+                char c = 0;
+                if (write(state->wakeup_fds[1], &c, 1) == -1)
+                {
+                    // The pipe is full, which means that Ruby already has
+                    // a pending notification
+                }
+            }
+        }
+    }
+
+    VALUE task;
+    boost::shared_ptr<State> state;
+    boost::thread thread;
+};
+
+/** call-seq:
+ *     do_create_state_multiplexer(klass, capacity)
+ *
+ */
+static void state_multiplexer_mark(StateMultiplexer* multiplexer)
+{
+    rb_gc_mark(multiplexer->rubyTask());
+}
+
+static VALUE local_task_context_create_state_multiplexer(VALUE _task, VALUE _klass, VALUE capacity)
+{
+    local_task_context(_task);
+    StateMultiplexer* multiplexer = 0;
+    try { multiplexer = new StateMultiplexer(_task, NUM2INT(capacity)); }
+    catch(std::exception& e)
+    { rb_raise(rb_eRuntimeError, "%s", e.what()); }
+
+    VALUE ruby_multiplexer = Data_Wrap_Struct(_klass, state_multiplexer_mark, delete_object<StateMultiplexer>, multiplexer);
+    VALUE args[1] = { rb_iv_get(_task, "@remote_task") };
+    rb_obj_call_init(ruby_multiplexer, 1, args);
+    return ruby_multiplexer;
+}
+
+static VALUE state_multiplexer_wakeup_fd(VALUE self)
+{
+    return INT2FIX(get_wrapped<StateMultiplexer>(self).wakeupFD());
+}
+
+static VALUE state_multiplexer_watch(VALUE self, VALUE id, VALUE port_name)
+{
+    StateMultiplexer& multiplexer = get_wrapped<StateMultiplexer>(self);
+    LocalTaskContext& task = local_task_context(multiplexer.rubyTask());
+    multiplexer.watch(task, NUM2LONG(id), StringValuePtr(port_name));
+    return Qnil;
+}
+
+static VALUE state_multiplexer_unwatch(VALUE self, VALUE id)
+{
+    get_wrapped<StateMultiplexer>(self).unwatch(NUM2LONG(id));
+    return Qnil;
+}
+
+static VALUE state_multiplexer_poll(VALUE self, VALUE id)
+{
+    get_wrapped<StateMultiplexer>(self).poll(NUM2LONG(id));
+    return Qnil;
+}
+
+static VALUE state_multiplexer_dropped_count(VALUE self)
+{
+    return ULONG2NUM(get_wrapped<StateMultiplexer>(self).droppedCount());
+}
+
+// Returns the state changes queued by the multiplexer thread, as a list of
+// [id, state, time]
+static VALUE state_multiplexer_drain(VALUE self)
+{
+    std::vector<StateMultiplexer::Record> records;
+    get_wrapped<StateMultiplexer>(self).drain(records);
+
+    VALUE result = rb_ary_new2(records.size());
+    for (size_t i = 0; i < records.size(); ++i)
+    {
+        VALUE entry = rb_ary_new();
+        rb_ary_push(entry, LONG2NUM(records[i].id));
+        rb_ary_push(entry, INT2FIX(records[i].state));
+        rb_ary_push(entry, rb_time_nano_new(records[i].time.tv_sec, records[i].time.tv_nsec));
+        rb_ary_push(result, entry);
+    }
+    return result;
+}
+
+/** Keeps the last samples received on a set of input ports of a local task
+ *
+ * Each recorded port has a ring of preallocated slots. As with the
+ * StateMultiplexer, the ports' new-data callbacks only mark the ports, and
+ * a dedicated thread reads them and marshals the samples with typelib into
+ * the oldest slots along with their reception time. Ruby is involved only
+ * when the content of the rings is requested with snapshot()
+ *
+ * As with InputPortGroup, the callbacks are bound to a reference-counted
+ * state that is flagged as closed when the recorder gets destroyed. The
+ * state's mutex only protects the set of recorded ports and the
+ * notifications, so that the writers' callbacks never wait on the reading
+ * and marshalling of samples. Each ring has its own mutex, which is held
+ * while the thread fills the ring and while snapshot() copies it
+ */
+class FlightRecorder
+{
+public:
+    struct Slot
+    {
+        timespec time;
+        std::vector<uint8_t> data;
+    };
+
+    /** +task+ is the Ruby object that wraps the local task context. As in
+     * StateMultiplexer, it is resolved with local_task_context() each time
+     * it is needed
+     */
+    FlightRecorder(VALUE task)
+        : task(task)
+        , state(new State)
+    {
+        thread = boost::thread(boost::bind(&FlightRecorder::run, state));
+    }
+
+    ~FlightRecorder()
+    {
+        {
+            boost::mutex::scoped_lock lock(state->mutex);
+            state->closed = true;
+        }
+        state->cond.notify_all();
+        thread.join();
+
+        while (!state->entries.empty())
+            unrecord(state->entries.begin()->first);
+    }
+
+    /** The Ruby object that wraps the local task context */
+    VALUE rubyTask() const { return task; }
+
+    /** Creates on +task+ the input port that will receive the samples
+     * recorded under +id+
+     *
+     * @param type the typelib type of the samples, as handled by the
+     *   binding's typelib transport
+     * @param capacity the number of samples kept
+     * @param reserve the number of bytes preallocated for each sample
+     */
+    void record(LocalTaskContext& task, long id, std::string const& port_name, RTypeBinding const& binding,
+            Typelib::Type const& type, size_t capacity, size_t reserve)
+    {
+        if (!binding.typelib_transport)
+            throw std::runtime_error("there is no typelib transport for " + type.getName());
+        RTT::types::ConnFactoryPtr factory = binding.type_info->getPortFactory();
+        if (!factory)
+            throw std::runtime_error("it seems that the typekit for " + type.getName() + " does not include the necessary factory");
+
+        boost::shared_ptr<Entry> entry(new Entry(type, capacity, reserve));
+        entry->transport = binding.typelib_transport;
+        entry->handle = entry->transport->createHandle();
+        entry->sample = entry->transport->getDataSource(entry->handle);
+        entry->port = factory->inputPort(port_name);
+        entry->callback = entry->port->getNewDataOnPortEvent()->connect(
+                boost::bind(&FlightRecorder::newData, state, id));
+        task.ports()->addPort(*entry->port);
+
+        boost::mutex::scoped_lock lock(state->mutex);
+        state->entries[id] = entry;
+    }
+
+    void unrecord(long id)
+    {
+        boost::shared_ptr<Entry> entry;
+        {
+            boost::mutex::scoped_lock lock(state->mutex);
+            std::map< long, boost::shared_ptr<Entry> >::iterator it = state->entries.find(id);
+            if (it == state->entries.end())
+                return;
+            entry = it->second;
+            state->entries.erase(it);
+            state->dirty.erase(id);
+        }
+
+        // The thread might still be reading the port, in which case it
+        // holds a reference on the entry. Wait for it to finish, and let it
+        // know that the port is gone
+        boost::mutex::scoped_lock lock(entry->mutex);
+        entry->removed = true;
+        entry->callback.disconnect();
+        entry->port->disconnect();
+        if (entry->port->getInterface())
+            entry->port->getInterface()->removePort(entry->port->getName());
+    }
+
+    /** Makes the thread read the port of +id+ even if it did not get a
+     * new-data notification
+     */
+    void poll(long id)
+    { newData(state, id); }
+
+    /** Copies the samples recorded under +id+ that were received at or
+     * after +since+, oldest first
+     */
+    void snapshot(long id, timespec const& since, std::vector<Slot>& result)
+    {
+        boost::shared_ptr<Entry> entry_ptr;
+        {
+            boost::mutex::scoped_lock lock(state->mutex);
+            std::map< long, boost::shared_ptr<Entry> >::const_iterator it = state->entries.find(id);
+            if (it == state->entries.end())
+                return;
+            entry_ptr = it->second;
+        }
+
+        Entry const& entry = *entry_ptr;
+        boost::mutex::scoped_lock lock(entry.mutex);
+        size_t capacity = entry.ring.size();
+        size_t first = (entry.next + capacity - entry.count) % capacity;
+        for (size_t i = 0; i < entry.count; ++i)
+        {
+            Slot const& slot = entry.ring[(first + i) % capacity];
+            if (slot.time.tv_sec < since.tv_sec ||
+                    (slot.time.tv_sec == since.tv_sec && slot.time.tv_nsec < since.tv_nsec))
+                continue;
+            result.push_back(slot);
+        }
+    }
+
+private:
+    struct Entry
+    {
+        RTT::base::InputPortInterface* port;
+        RTT::Handle callback;
+        orogen_transports::TypelibMarshallerBase* transport;
+        orogen_transports::TypelibMarshallerBase::Handle* handle;
+        RTT::base::DataSourceBase::shared_ptr sample;
+        Typelib::Type const& type;
+        Typelib::MemoryLayout layout;
+
+        // Protects the fields below, i.e. the ring and the port's state
+        mutable boost::mutex mutex;
+        bool removed;
+        std::vector<Slot> ring;
+        size_t next;
+        size_t count;
+
+        Entry(Typelib::Type const& type, size_t capacity, size_t reserve)
+            : port(0)
+            , transport(0)
+            , handle(0)
+            , type(type)
+            , layout(Typelib::layout_of(type))
+            , removed(false)
+            , ring(capacity)
+            , next(0)
+            , count(0)
+        {
+            for (size_t i = 0; i < capacity; ++i)
+                ring[i].data.reserve(reserve);
+        }
+
+        ~Entry()
+        {
+            sample.reset();
+            if (handle)
+                transport->deleteHandle(handle);
+            delete port;
+        }
+    };
+
+    struct State
+    {
+        // Protects the fields below
+        boost::mutex mutex;
+        boost::condition_variable cond;
+        bool closed;
+        std::map< long, boost::shared_ptr<Entry> > entries;
+        std::set<long> dirty;
+
+        State()
+            : closed(false) {}
+    };
+
+    static void newData(boost::shared_ptr<State> state, long id)
+    {
+        {
+            boost::mutex::scoped_lock lock(state->mutex);
+            if (state->closed)
+                return;
+            state->dirty.insert(id);
+        }
+        state->cond.notify_all();
+    }
+
+    static void run(boost::shared_ptr<State> state)
+    {
+        std::set<long> ready;
+        std::vector< boost::shared_ptr<Entry> > ready_entries;
+        while (true)
+        {
+            {
+                boost::mutex::scoped_lock lock(state->mutex);
+                while (state->dirty.empty() && !state->closed)
+                    state->cond.wait(lock);
+                if (state->closed)
+                    return;
+                ready.swap(state->dirty);
+
+                for (std::set<long>::const_iterator it = ready.begin(); it != ready.end(); ++it)
+                {
+                    std::map< long, boost::shared_ptr<Entry> >::iterator entry = state->entries.find(*it);
+                    if (entry != state->entries.end())
+                        ready_entries.push_back(entry->second);
+                }
+                ready.clear();
+            }
+
+            for (size_t i = 0; i < ready_entries.size(); ++i)
+                readAll(*ready_entries[i]);
+            ready_entries.clear();
+        }
+    }
+
+    static void readAll(Entry& entry)
+    {
+        boost::mutex::scoped_lock lock(entry.mutex);
+        if (entry.removed)
+            return;
+
+        while (entry.port->read(entry.sample, false) == RTT::NewData)
+        {
+            entry.transport->refreshTypelibSample(entry.handle);
+            Typelib::Value value(entry.transport->getTypelibSample(entry.handle), entry.type);
+
+            // Reuse the slot's buffer, which avoids allocations once the
+            // slots are big enough for the samples
+            Slot& slot = entry.ring[entry.next];
+            clock_gettime(CLOCK_REALTIME, &slot.time);
+            slot.data.clear();
+            Typelib::dump(value, slot.data, entry.layout);
+
+            entry.next = (entry.next + 1) % entry.ring.size();
+            if (entry.count < entry.ring.size())
+                ++entry.count;
+        }
+    }
+
+    VALUE task;
+    boost::shared_ptr<State> state;
+    boost::thread thread;
+};
+
+static void flight_recorder_mark(FlightRecorder* recorder)
+{
+    rb_gc_mark(recorder->rubyTask());
+}
+
+/** call-seq:
+ *     do_create_flight_recorder(klass)
+ *
+ */
+static VALUE local_task_context_create_flight_recorder(VALUE _task, VALUE _klass)
+{
+    local_task_context(_task);
+    FlightRecorder* recorder = 0;
+    try { recorder = new FlightRecorder(_task); }
+    catch(std::exception& e)
+    { rb_raise(rb_eRuntimeError, "%s", e.what()); }
+
+    VALUE ruby_recorder = Data_Wrap_Struct(_klass, flight_recorder_mark, delete_object<FlightRecorder>, recorder);
+    VALUE args[1] = { rb_iv_get(_task, "@remote_task") };
+    rb_obj_call_init(ruby_recorder, 1, args);
+    return ruby_recorder;
+}
+
+/** call-seq:
+ *     do_record(id, port_name, type_binding, sample, capacity, reserve)
+ *
+ * Creates the input port that receives the samples recorded under +id+.
+ * +sample+ is a typelib value of the recorded type
+ */
+static VALUE flight_recorder_record(VALUE self, VALUE id, VALUE port_name, VALUE type_binding, VALUE sample, VALUE capacity, VALUE reserve)
+{
+    RTypeBinding const& binding = get_type_binding(type_binding);
+    Typelib::Type const& type = typelib_get(sample).getType();
+    size_t capacity_ = NUM2ULONG(capacity);
+    if (capacity_ == 0)
+        rb_raise(rb_eArgError, "the capacity must be at least one sample");
+    long id_ = NUM2LONG(id);
+    size_t reserve_ = NUM2ULONG(reserve);
+    char const* port_name_ = StringValueCStr(port_name);
+    FlightRecorder& recorder = get_wrapped<FlightRecorder>(self);
+    LocalTaskContext& task = local_task_context(recorder.rubyTask());
+
+    std::string error;
+    try
+    {
+        recorder.record(task, id_, port_name_,
+                binding, type, capacity_, reserve_);
+    }
+    catch(std::exception& e)
+    { error = e.what(); }
+
+    if (!error.empty())
+        rb_raise(rb_eArgError, "%s", error.c_str());
+    return Qnil;
+}
+
+static VALUE flight_recorder_unrecord(VALUE self, VALUE id)
+{
+    get_wrapped<FlightRecorder>(self).unrecord(NUM2LONG(id));
+    return Qnil;
+}
+
+static VALUE flight_recorder_poll(VALUE self, VALUE id)
+{
+    get_wrapped<FlightRecorder>(self).poll(NUM2LONG(id));
+    return Qnil;
+}
+
+// Returns the samples recorded under +id+ since the given time (or all of
+// them if it is nil), as a list of [time, marshalled_sample]
+static VALUE flight_recorder_snapshot(VALUE self, VALUE id, VALUE since)
+{
+    timespec since_ts = { 0, 0 };
+    if (!NIL_P(since))
+        since_ts = rb_time_timespec(since);
+
+    std::vector<FlightRecorder::Slot> slots;
+    get_wrapped<FlightRecorder>(self).snapshot(NUM2LONG(id), since_ts, slots);
+
+    VALUE result = rb_ary_new2(slots.size());
+    for (size_t i = 0; i < slots.size(); ++i)
+    {
+        VALUE entry = rb_ary_new();
+        rb_ary_push(entry, rb_time_nano_new(slots[i].time.tv_sec, slots[i].time.tv_nsec));
+        std::vector<uint8_t> const& data = slots[i].data;
+        rb_ary_push(entry, rb_str_new(data.empty() ? "" : reinterpret_cast<char const*>(&data[0]), data.size()));
+        rb_ary_push(result, entry);
+    }
+    return result;
+}
+
+/** Lets a Ruby thread wait, with the GVL released, for a local input port to
+ * receive new data
+ *
+ * The port's new-data callback sets a flag that wait() consumes. Since the
+ * callback is connected when the waiter is created, data that arrives between
+ * a read and the following wait() is not missed, at the cost of spurious
+ * wakeups when the data got read already
+ *
+ * As with InputPortGroup, the callback is bound to a reference-counted state
+ * that is flagged as closed when the waiter gets destroyed
+ */
+class NewDataWaiter
+{
+public:
+    NewDataWaiter(RTT::base::InputPortInterface& port)
+        : state(new State)
+    {
+        callback = port.getNewDataOnPortEvent()->connect(
+                boost::bind(&NewDataWaiter::signal, state));
+    }
+
+    ~NewDataWaiter()
+    {
+        {
+            boost::mutex::scoped_lock lock(state->mutex);
+            state->closed = true;
+        }
+        callback.disconnect();
+    }
+
+    /** Waits for the port to get new data, at most +timeout+ seconds
+     *
+     * A negative timeout waits forever
+     *
+     * @return true if the port got new data, false on timeout or if the wait
+     *   got aborted
+     */
+    bool wait(double timeout)
+    {
+        boost::mutex::scoped_lock lock(state->mutex);
+        boost::system_time deadline = boost::get_system_time() +
+            boost::posix_time::microseconds(static_cast<int64_t>(timeout * 1e6));
+        while (!state->signalled && !state->aborted)
+        {
+            if (timeout < 0)
+                state->cond.wait(lock);
+            else if (!state->cond.timed_wait(lock, deadline))
+                break;
+        }
+        bool result = state->signalled;
+        state->signalled = false;
+        state->aborted = false;
+        return result;
+    }
+
+    void abort()
+    {
+        boost::mutex::scoped_lock lock(state->mutex);
+        state->aborted = true;
+        state->cond.notify_all();
+    }
+
+private:
+    struct State
+    {
+        boost::mutex mutex;
+        boost::condition_variable cond;
+        bool signalled;
+        bool aborted;
+        bool closed;
+
+        State()
+            : signalled(false)
+            , aborted(false)
+            , closed(false) {}
+    };
+
+    static void signal(boost::shared_ptr<State> state)
+    {
+        boost::mutex::scoped_lock lock(state->mutex);
+        if (state->closed)
+            return;
+        state->signalled = true;
+        state->cond.notify_all();
+    }
+
+    boost::shared_ptr<State> state;
+    RTT::Handle callback;
+};
+
+static VALUE new_data_waiter_new(VALUE klass, VALUE _local_port)
+{
+    RTT::base::InputPortInterface& local_port = get_wrapped<RTT::base::InputPortInterface>(_local_port);
+    VALUE ruby_waiter = Data_Wrap_Struct(klass, 0, delete_object<NewDataWaiter>, new NewDataWaiter(local_port));
+    rb_obj_call_init(ruby_waiter, 1, &_local_port);
+    return ruby_waiter;
+}
+
+/** call-seq:
+ *     do_wait(timeout) => true or false
+ *
+ * Waits for new data at most +timeout+ seconds, or forever if it is nil.
+ * Returns false on timeout
+ */
+static VALUE new_data_waiter_wait(VALUE self, VALUE timeout)
+{
+    NewDataWaiter& waiter = get_wrapped<NewDataWaiter>(self);
+    double timeout_s = NIL_P(timeout) ? -1 : NUM2DBL(timeout);
+    bool result = blocking_fct_call_with_result(
+            boost::bind(&NewDataWaiter::wait, &waiter, timeout_s),
+            boost::bind(&NewDataWaiter::abort, &waiter));
+    return result ? Qtrue : Qfalse;
+}
+
+/** Notifies Ruby through a pipe when any port of a set of local input ports
+ * receives new data
+ *
+ * The ports' new-data callbacks only record which port got data and write to
+ * the pipe if it is not already signalled. The ports are then read from Ruby,
+ * which can wait on the pipe for any number of ports at once
+ *
+ * The callbacks are bound to a reference-counted state rather than to the
+ * group itself, as a writer thread might still be running one of them while
+ * the group gets destroyed. The state is flagged as closed under its mutex,
+ * after which the callbacks do nothing
+ */
+class InputPortGroup
+{
+public:
+    InputPortGroup()
+        : state(new State)
+    {
+        if (pipe(state->wakeup_fds) == -1)
+            throw std::runtime_error("cannot create the port group's wakeup pipe");
+        for (int i = 0; i < 2; ++i)
+            fcntl(state->wakeup_fds[i], F_SETFL, fcntl(state->wakeup_fds[i], F_GETFL) | O_NONBLOCK);
+    }
+
+    ~InputPortGroup()
+    {
+        std::map<long, RTT::Handle> callbacks;
+        {
+            boost::mutex::scoped_lock lock(state->mutex);
+            callbacks.swap(state->callbacks);
+            state->ready.clear();
+            state->closed = true;
+            close(state->wakeup_fds[0]);
+            close(state->wakeup_fds[1]);
+        }
+        for (std::map<long, RTT::Handle>::iterator it = callbacks.begin(); it != callbacks.end(); ++it)
+            it->second.disconnect();
+    }
+
+    int wakeupFD() const { return state->wakeup_fds[0]; }
+
+    /** Starts monitoring +port+, identified by +id+
+     *
+     * The port is reported as ready once, as it may have received data
+     * before being added
+     */
+    void add(long id, RTT::base::InputPortInterface& port)
+    {
+        RTT::Handle callback = port.getNewDataOnPortEvent()->connect(
+                boost::bind(&InputPortGroup::newData, state, id));
+        {
+            boost::mutex::scoped_lock lock(state->mutex);
+            state->callbacks[id] = callback;
+        }
+        newData(state, id);
+    }
+
+    void remove(long id)
+    {
+        RTT::Handle callback;
+        {
+            boost::mutex::scoped_lock lock(state->mutex);
+            std::map<long, RTT::Handle>::iterator it = state->callbacks.find(id);
+            if (it == state->callbacks.end())
+                return;
+            callback = it->second;
+            state->callbacks.erase(it);
+            state->ready.erase(id);
+        }
+        callback.disconnect();
+    }
+
+    /** Returns the IDs of the ports that received data since the last call
+     */
+    void drain(std::vector<long>& ids)
+    {
+        boost::mutex::scoped_lock lock(state->mutex);
+        ids.assign(state->ready.begin(), state->ready.end());
+        state->ready.clear();
+        char buffer[64];
+        while (read(state->wakeup_fds[0], buffer, sizeof(buffer)) > 0);
+    }
+
+private:
+    struct State
+    {
+        boost::mutex mutex;
+        std::map<long, RTT::Handle> callbacks;
+        std::set<long> ready;
+        int wakeup_fds[2];
+        bool closed;
+
+        State()
+            : closed(false) {}
+    };
+
+    static void newData(boost::shared_ptr<State> state, long id)
+    {
+        boost::mutex::scoped_lock lock(state->mutex);
+        if (state->closed || state->callbacks.find(id) == state->callbacks.end())
+            return;
+
+        bool signalled = !state->ready.empty();
+        state->ready.insert(id);
+        if (!signalled)
+        {
+            char c = 0;
+            if (write(state->wakeup_fds[1], &c, 1) == -1)
+            {
+                // The pipe is full, which means that Ruby already has a
+                // pending notification
+            }
+        }
+    }
+
+    boost::shared_ptr<State> state;
+};
+
+static VALUE input_port_group_new(VALUE klass)
+{
+    InputPortGroup* group = 0;
+    try { group = new InputPortGroup; }
+    catch(std::exception& e)
+    { rb_raise(rb_eRuntimeError, "%s", e.what()); }
+
+    VALUE ruby_group = Data_Wrap_Struct(klass, 0, delete_object<InputPortGroup>, group);
+    rb_obj_call_init(ruby_group, 0, 0);
+    return ruby_group;
+}
+
+static VALUE input_port_group_wakeup_fd(VALUE self)
+{
+    return INT2FIX(get_wrapped<InputPortGroup>(self).wakeupFD());
+}
+
+static VALUE input_port_group_add(VALUE self, VALUE id, VALUE _local_port)
+{
+    RTT::base::InputPortInterface& local_port = get_wrapped<RTT::base::InputPortInterface>(_local_port);
+    get_wrapped<InputPortGroup>(self).add(NUM2LONG(id), local_port);
+    return Qnil;
+}
+
+static VALUE input_port_group_remove(VALUE self, VALUE id)
+{
+    get_wrapped<InputPortGroup>(self).remove(NUM2LONG(id));
+    return Qnil;
+}
+
+// Returns the IDs of the ports that got new data since the last call
+static VALUE input_port_group_drain(VALUE self)
+{
+    std::vector<long> ids;
+    get_wrapped<InputPortGroup>(self).drain(ids);
+
+    VALUE result = rb_ary_new2(ids.size());
+    for (size_t i = 0; i < ids.size(); ++i)
+        rb_ary_push(result, LONG2NUM(ids[i]));
+    return result;
+}
+
+/** Location of a field in the samples of a given type
+ *
+ * The offset is resolved once from the typelib type, so that extracting the
+ * field only touches the field's own memory. Only fields that are at a fixed
+ * offset can be projected, i.e. the path may only go through compounds and
+ * static arrays
+ */
+struct FieldProjection
+{
+    Typelib::Type const* sample_type;
+    Typelib::Type const* field_type;
+    size_t offset;
+};
+
+/** call-seq:
+ *     FieldProjection.new(sample, path)
+ *
+ * Resolves +path+, an array of field names and array indexes, in the type of
+ * +sample+. Raises ArgumentError if the path does not exist or goes through a
+ * type whose elements are not at fixed offsets (e.g. a container)
+ */
+static VALUE field_projection_new(VALUE klass, VALUE sample, VALUE path)
+{
+    Typelib::Type const* sample_type = &typelib_get(sample).getType();
+    Typelib::Type const* type = sample_type;
+    size_t offset = 0;
+
+    for (int i = 0; i < RARRAY_LEN(path); ++i)
+    {
+        VALUE element = rb_ary_entry(path, i);
+        if (type->getCategory() == Typelib::Type::Compound)
+        {
+            Typelib::Compound const& compound = static_cast<Typelib::Compound const&>(*type);
+            Typelib::Field const* field = compound.getField(StringValueCStr(element));
+            if (!field)
+                rb_raise(rb_eArgError, "%s has no field called %s",
+                        type->getName().c_str(), StringValueCStr(element));
+            offset += field->getOffset();
+            type = &field->getType();
+        }
+        else if (type->getCategory() == Typelib::Type::Array)
+        {
+            Typelib::Array const& array = static_cast<Typelib::Array const&>(*type);
+            long index = NUM2LONG(element);
+            if (index < 0 || index >= static_cast<long>(array.getDimension()))
+                rb_raise(rb_eArgError, "index %li out of bounds for %s",
+                        index, type->getName().c_str());
+            type = &array.getIndirection();
+            offset += index * type->getSize();
+        }
+        else
+            rb_raise(rb_eArgError, "cannot project through %s, only compounds and static arrays have elements at fixed offsets",
+                    type->getName().c_str());
+    }
+
+    FieldProjection* projection = new FieldProjection;
+    projection->sample_type = sample_type;
+    projection->field_type = type;
+    projection->offset = offset;
+    VALUE ruby_projection = Data_Wrap_Struct(klass, 0, delete_object<FieldProjection>, projection);
+    VALUE args[2] = { sample, path };
+    rb_obj_call_init(ruby_projection, 2, args);
+    return ruby_projection;
+}
+
+static VALUE numeric_to_ruby(Typelib::Numeric const& type, uint8_t const* data)
+{
+    switch(type.getNumericCategory())
+    {
+        case Typelib::Numeric::Float:
+            if (type.getSize() == sizeof(float))
+                return rb_float_new(*reinterpret_cast<float const*>(data));
+            return rb_float_new(*reinterpret_cast<double const*>(data));
+        case Typelib::Numeric::SInt:
+            switch(type.getSize())
+            {
+                case 1: return INT2FIX(*reinterpret_cast<int8_t const*>(data));
+                case 2: return INT2FIX(*reinterpret_cast<int16_t const*>(data));
+                case 4: return INT2NUM(*reinterpret_cast<int32_t const*>(data));
+                case 8: return LL2NUM(*reinterpret_cast<int64_t const*>(data));
+            }
+            break;
+        case Typelib::Numeric::UInt:
+            switch(type.getSize())
+            {
+                case 1: return INT2FIX(*reinterpret_cast<uint8_t const*>(data));
+                case 2: return INT2FIX(*reinterpret_cast<uint16_t const*>(data));
+                case 4: return UINT2NUM(*reinterpret_cast<uint32_t const*>(data));
+                case 8: return ULL2NUM(*reinterpret_cast<uint64_t const*>(data));
+            }
+            break;
+    }
+    rb_raise(rb_eArgError, "unsupported numeric type %s", type.getName().c_str());
+}
+
+/** call-seq:
+ *     do_extract(sample, field) => field or number
+ *
+ * Copies the projected field of +sample+ into +field+, a typelib value of the
+ * field's type. If +field+ is nil, the field must be numeric and is returned
+ * as a Ruby number
+ */
+static VALUE field_projection_extract(VALUE self, VALUE rb_sample, VALUE rb_field)
+{
+    FieldProjection const& projection = get_wrapped<FieldProjection>(self);
+    Typelib::Value sample = typelib_get(rb_sample);
+    if (sample.getType() != *projection.sample_type)
+        rb_raise(rb_eArgError, "expected a sample of type %s, got %s",
+                projection.sample_type->getName().c_str(), sample.getType().getName().c_str());
+
+    uint8_t* data = static_cast<uint8_t*>(sample.getData()) + projection.offset;
+    if (NIL_P(rb_field))
+    {
+        if (projection.field_type->getCategory() != Typelib::Type::Numeric)
+            rb_raise(rb_eArgError, "%s is not numeric, a field sample must be given",
+                    projection.field_type->getName().c_str());
+        return numeric_to_ruby(static_cast<Typelib::Numeric const&>(*projection.field_type), data);
+    }
+
+    Typelib::Value field = typelib_get(rb_field);
+    if (field.getType() != *projection.field_type)
+        rb_raise(rb_eArgError, "expected a field sample of type %s, got %s",
+                projection.field_type->getName().c_str(), field.getType().getName().c_str());
+    Typelib::copy(field, Typelib::Value(data, *projection.field_type));
+    return rb_field;
+}
+
 void Orocos_init_ruby_task_context(VALUE mOrocos, VALUE cTaskContext, VALUE cOutputPort, VALUE cInputPort)
 {
     VALUE mRubyTasks = rb_define_module_under(mOrocos, "RubyTasks");
@@ -445,11 +1635,44 @@ void Orocos_init_ruby_task_context(VALUE mOrocos, VALUE cTaskContext, VALUE cOut
     rb_define_method(cLocalTaskContext, "do_create_property", RUBY_METHOD_FUNC(local_task_context_create_property), 3);
     rb_define_method(cLocalTaskContext, "do_create_attribute", RUBY_METHOD_FUNC(local_task_context_create_attribute), 3);
     rb_define_method(cLocalTaskContext, "exception", RUBY_METHOD_FUNC(local_task_context_exception), 0);
+    rb_define_method(cLocalTaskContext, "do_create_state_multiplexer", RUBY_METHOD_FUNC(local_task_context_create_state_multiplexer), 2);
+    rb_define_method(cLocalTaskContext, "do_create_flight_recorder", RUBY_METHOD_FUNC(local_task_context_create_flight_recorder), 1);
+
+    cStateMultiplexer = rb_define_class_under(mOrocos, "StateMultiplexer", rb_cObject);
+    rb_define_method(cStateMultiplexer, "wakeup_fd", RUBY_METHOD_FUNC(state_multiplexer_wakeup_fd), 0);
+    rb_define_method(cStateMultiplexer, "do_watch", RUBY_METHOD_FUNC(state_multiplexer_watch), 2);
+    rb_define_method(cStateMultiplexer, "do_unwatch", RUBY_METHOD_FUNC(state_multiplexer_unwatch), 1);
+    rb_define_method(cStateMultiplexer, "do_poll", RUBY_METHOD_FUNC(state_multiplexer_poll), 1);
+    rb_define_method(cStateMultiplexer, "do_drain", RUBY_METHOD_FUNC(state_multiplexer_drain), 0);
+    rb_define_method(cStateMultiplexer, "dropped_count", RUBY_METHOD_FUNC(state_multiplexer_dropped_count), 0);
+
+    cFlightRecorder = rb_define_class_under(mOrocos, "FlightRecorder", rb_cObject);
+    rb_define_method(cFlightRecorder, "do_record", RUBY_METHOD_FUNC(flight_recorder_record), 6);
+    rb_define_method(cFlightRecorder, "do_unrecord", RUBY_METHOD_FUNC(flight_recorder_unrecord), 1);
+    rb_define_method(cFlightRecorder, "do_poll", RUBY_METHOD_FUNC(flight_recorder_poll), 1);
+    rb_define_method(cFlightRecorder, "do_snapshot", RUBY_METHOD_FUNC(flight_recorder_snapshot), 2);
 
     cLocalOutputPort = rb_define_class_under(mRubyTasks, "LocalOutputPort", cOutputPort);
     rb_define_method(cLocalOutputPort, "do_write", RUBY_METHOD_FUNC(local_output_port_write), 2);
+    rb_define_method(cLocalOutputPort, "do_write_batch", RUBY_METHOD_FUNC(local_output_port_write_batch), 2);
     cLocalInputPort = rb_define_class_under(mRubyTasks, "LocalInputPort", cInputPort);
     rb_define_method(cLocalInputPort, "do_read", RUBY_METHOD_FUNC(local_input_port_read), 4);
+    rb_define_method(cLocalInputPort, "do_read_batch", RUBY_METHOD_FUNC(local_input_port_read_batch), 3);
     rb_define_method(cLocalInputPort, "do_clear", RUBY_METHOD_FUNC(local_input_port_clear), 0);
+
+    cNewDataWaiter = rb_define_class_under(mRubyTasks, "NewDataWaiter", rb_cObject);
+    rb_define_singleton_method(cNewDataWaiter, "new", RUBY_METHOD_FUNC(new_data_waiter_new), 1);
+    rb_define_method(cNewDataWaiter, "do_wait", RUBY_METHOD_FUNC(new_data_waiter_wait), 1);
+
+    cInputPortGroup = rb_define_class_under(mRubyTasks, "InputPortGroup", rb_cObject);
+    rb_define_singleton_method(cInputPortGroup, "new", RUBY_METHOD_FUNC(input_port_group_new), 0);
+    rb_define_method(cInputPortGroup, "wakeup_fd", RUBY_METHOD_FUNC(input_port_group_wakeup_fd), 0);
+    rb_define_method(cInputPortGroup, "do_add", RUBY_METHOD_FUNC(input_port_group_add), 2);
+    rb_define_method(cInputPortGroup, "do_remove", RUBY_METHOD_FUNC(input_port_group_remove), 1);
+    rb_define_method(cInputPortGroup, "do_drain", RUBY_METHOD_FUNC(input_port_group_drain), 0);
+
+    cFieldProjection = rb_define_class_under(mRubyTasks, "FieldProjection", rb_cObject);
+    rb_define_singleton_method(cFieldProjection, "new", RUBY_METHOD_FUNC(field_projection_new), 2);
+    rb_define_method(cFieldProjection, "do_extract", RUBY_METHOD_FUNC(field_projection_extract), 2);
 }
 
@@ -60,6 +60,8 @@ module Orocos
 require 'orocos/ruby_tasks'
 require 'orocos/input_writer'
 require 'orocos/output_reader'
+require 'orocos/state_multiplexer'
+require 'orocos/flight_recorder'
 # This backward-compatibility code !
 require 'orocos/ruby_task_context'
 
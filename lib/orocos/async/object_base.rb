@@ -388,6 +388,9 @@ def remove_all_listeners
         # calls all listener which are registered for the given event
         def process_event(event_name,*args,&block)
             event = validate_event event_name
+            # Listeners may have been removed since the event got queued. Do
+            # not compute the arguments for nothing
+            return self if @listeners[event_name].empty?
             args = block.call if block
             #@listeners have to be cloned because it might get modified 
             #by listener.call
@@ -13,16 +13,37 @@ class OutputReader < Orocos::Async::ObjectBase
         # The event loop timer that is polling the connection
         attr_reader :poll_timer
 
+        # The number of samples that got read but not emitted because of
+        # {#coalesce?}
+        #
+        # @return [Integer]
+        attr_reader :dropped_sample_count
+
+        # Whether only the newest sample read during a poll period is
+        # emitted
+        #
+        # It is meant for monitoring high-rate ports where only the latest
+        # value matters (e.g. in a GUI). The other samples are counted in
+        # {#dropped_sample_count}
+        attr_predicate :coalesce?, true
+
         self.default_period = 0.1
 
+        # Max. number of samples read at once when draining the connection
+        # in {#coalesce?} mode
+        COALESCE_BATCH_SIZE = 64
+
         # @param [Async::OutputPort] port The Asyn::OutputPort
         # @param [Orocos::OutputReader] reader The designated reader
-        def initialize(port, reader, period: default_period)
+        # @param [Boolean] coalesce see {#coalesce?}
+        def initialize(port, reader, period: default_period, coalesce: false)
             super(port.name,port.event_loop)
             @port = port
             @raw_last_sample = nil
             @policy = reader.policy
             @period = period
+            @coalesce = coalesce
+            @dropped_sample_count = 0
 
             timeout =
                 if reader.policy[:type] == :buffer
@@ -117,18 +138,59 @@ def remove_listener(listener)
         # blocking method called from thread pool to read new data
         def thread_read(timeout)
             deadline = Time.now + timeout
+            if coalesce?
+                return thread_read_coalesced(deadline)
+            end
+
             raw_last_sample = nil
             while data = raw_read_new # sync call from bg thread
                 raw_last_sample = data
-                event :raw_data, data
-                # TODO just emit raw_data and convert it to ruby
-                # if someone is listening to (see PortProxy)
-                event(:data) { [Typelib.to_ruby(data)] }
+                emit_sample(data)
                 break if Time.now > deadline
             end
             raw_last_sample
         end
 
+        # Implementation of {#thread_read} in {#coalesce?} mode
+        #
+        # It drains the connection in batches and only emits the newest
+        # sample
+        def thread_read_coalesced(deadline)
+            raw_last_sample = nil
+            read_count = 0
+            samples = Array.new
+            loop do
+                count = raw_read_new_batch(COALESCE_BATCH_SIZE, samples).size # sync call from bg thread
+                if count > 0
+                    read_count += count
+                    # Take the newest sample out of the array so that the
+                    # next batch does not overwrite it
+                    raw_last_sample = samples.delete_at(count - 1)
+                end
+                break if count < COALESCE_BATCH_SIZE || Time.now > deadline
+            end
+
+            if raw_last_sample
+                @dropped_sample_count += read_count - 1
+                emit_sample(raw_last_sample)
+            end
+            raw_last_sample
+        end
+
+        # Queues the data events for a sample
+        #
+        # The events are queued only if there are listeners for them, which
+        # in particular avoids converting the samples to Ruby if no one
+        # listens to :data
+        def emit_sample(data)
+            if number_of_listeners(:raw_data) != 0
+                event :raw_data, data
+            end
+            if number_of_listeners(:data) != 0
+                event(:data) { [Typelib.to_ruby(data)] }
+            end
+        end
+
         # callback after thread_read returns called from the main thread
         def thread_read_callback(data, error)
             if data
@@ -262,7 +324,7 @@ def options=(options)
         end
 
         def reader(options = Hash.new,&block)
-            options, policy = Kernel.filter_options options, :period => nil
+            options, policy = Kernel.filter_options options, :period => nil, :coalesce => false
             policy[:init] = true unless policy.has_key?(:init)
             policy[:pull] = true unless policy.has_key?(:pull)
             if block
@@ -354,9 +354,8 @@ def to_proxy(options=Hash.new)
         end
 
         def on_data(policy = Hash.new)
-            on_raw_data(policy) do |sample|
-                sample = Typelib.to_ruby(sample) if sample
-                yield(sample)
+            __getobj__.on_raw_data(policy) do |sample|
+                yield(subfield_to_ruby(sample))
             end
         end
 
@@ -417,6 +416,41 @@ def type
         end
 
         private
+        # Extracts the subfield from a full sample and converts it to Ruby
+        #
+        # A {RubyTasks::FieldProjection} is used if the subfield is at a
+        # fixed offset in the sample, so that only the subfield gets
+        # converted. Otherwise, it falls back to {#subfield}
+        def subfield_to_ruby(sample)
+            return unless sample
+            if projection = field_projection(sample.class)
+                projection.extract(sample)
+            elsif sample = subfield(sample,@subfield)
+                Typelib.to_ruby(sample)
+            end
+        end
+
+        # Returns the projection of the subfield for samples of the given
+        # type, or nil if the subfield cannot be projected
+        #
+        # FieldProjection raises ArgumentError if the path does not exist or
+        # is not at a fixed offset, and TypeError if an element of the path
+        # has the wrong type (e.g. an index on a struct)
+        def field_projection(sample_type)
+            if @subfield.empty?
+                return
+            elsif @field_projection_type != sample_type
+                # The type is stored along with the result, so that a failed
+                # projection is also re-computed when the type changes
+                @field_projection_type = sample_type
+                @field_projection =
+                    begin Orocos::RubyTasks::FieldProjection.new(sample_type.new, @subfield.map { |f| f.kind_of?(Symbol) ? f.to_s : f })
+                    rescue ArgumentError, TypeError
+                    end
+            end
+            @field_projection
+        end
+
         def subfield(sample,field)
             return unless sample
             field.each do |f|
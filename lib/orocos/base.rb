@@ -18,6 +18,33 @@ class AlreadyInitialized < RuntimeError; end
     class InternalError < RuntimeError; end
     class AmbiguousName < RuntimeError; end
     class PropertyChangeRejected < RuntimeError; end
+    # Exception raised when some of the writes done by
+    # {TaskContextBase#raw_write_properties} failed
+    class PropertyWriteFailed < RuntimeError
+        # The errors, as a mapping from the property name to the exception
+        #
+        # @return [Hash<String,Exception>]
+        attr_reader :errors
+
+        def initialize(errors)
+            @errors = errors
+            super(errors.values.map(&:message).join(", "))
+        end
+    end
+    # Exception raised when some of the calls done in parallel by e.g.
+    # {CORBA.parallel} or {TaskContext.states} failed
+    class ParallelCallFailed < RuntimeError
+        # The errors, as a mapping from the object on which the call was
+        # done to the exception
+        #
+        # @return [Hash<Object,Exception>]
+        attr_reader :errors
+
+        def initialize(errors)
+            @errors = errors
+            super(errors.map { |obj, e| "#{obj}: #{e.message}" }.join(", "))
+        end
+    end
     # @deprecated use OroGen::ConfigError instead
     ConfigError = OroGen::ConfigError
 
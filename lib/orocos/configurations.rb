@@ -767,6 +767,12 @@ def conf_as_typelib(names, override: false)
         #   configuration object
         # @param [Boolean] override the override argument of {#conf}
         # @return [void]
+        #
+        # The properties are written with {TaskContext#raw_write_properties}.
+        # The properties that have a setter operation are therefore written
+        # before the other ones, and all the writes are attempted even if some
+        # of them fail. If any write failed, the error of the first failing
+        # property (in the configuration order) is raised afterwards.
         def apply(task, config, override = false)
             if !config.kind_of?(Hash)
                 config = conf(config, override)
@@ -782,11 +788,16 @@ def apply(task, config, override = false)
             end
 
             timestamp = Time.now
+            properties = config.each_key.map { |prop_name| task.property(prop_name) }
+            values = task.raw_read_properties(properties)
             config.each do |prop_name, conf|
-                p = task.property(prop_name)
-                result = p.raw_read
-                result = TaskConfigurations.apply_conf_on_typelib_value(result, conf)
-                p.write(result, timestamp)
+                values[prop_name] = TaskConfigurations.apply_conf_on_typelib_value(values[prop_name], conf)
+            end
+            begin
+                task.raw_write_properties(values, timestamp)
+            rescue PropertyWriteFailed => e
+                first_failure = config.each_key.find { |name| e.errors.has_key?(name.to_s) }
+                raise e.errors.fetch(first_failure.to_s) { raise e }
             end
         end
 
@@ -881,11 +892,7 @@ def self.to_yaml(value)
         # Reads the configuration of a task into a property-name-to-typelib
         # value form
         def self.read_task_conf(task)
-            current_config = Hash.new
-            task.each_property do |prop|
-                current_config[prop.name] = prop.raw_read
-            end
-            current_config
+            task.raw_read_properties
         end
 
         # Specifies a string that describes in which context we are currently
@@ -62,6 +62,44 @@ def connect_timeout=(value)
                 do_connect_timeout(value)
                 @connect_timeout = value
             end
+
+            # Returns the timeout set by {with_call_timeout} for the calls of
+            # the current thread, in milliseconds
+            #
+            # @return [Integer,nil] the timeout, or nil if the calls use the
+            #   per-task or global timeouts
+            def thread_call_timeout
+                if settings = Thread.current[:__orocos_corba_call_timeout__]
+                    settings.first
+                end
+            end
+
+            # Sets the timeout, in milliseconds, of the CORBA calls made by the
+            # current thread within the given block
+            #
+            # It overrides the global timeout (see {call_timeout=}) but not the
+            # ones set with {TaskContext#call_timeout=}. It also applies to the
+            # calls that are run concurrently on behalf of this thread, as e.g.
+            # {TaskContext.rtt_states}.
+            #
+            # @param [Integer] timeout the timeout in milliseconds
+            # @param [Boolean] cancellable if true, state and property reads
+            #   are done in a helper thread so that interrupting the ruby thread
+            #   (e.g. with Thread#raise) returns immediately, while the call
+            #   finishes in the background
+            # @return the value returned by the block
+            #
+            # @example bound the latency of a state query
+            #   Orocos::CORBA.with_call_timeout(50) { task.rtt_state }
+            def with_call_timeout(timeout, cancellable: false)
+                previous = Thread.current[:__orocos_corba_call_timeout__]
+                Thread.current[:__orocos_corba_call_timeout__] = [timeout, cancellable]
+                do_thread_call_timeout(timeout, cancellable)
+                yield
+            ensure
+                Thread.current[:__orocos_corba_call_timeout__] = previous
+                do_thread_call_timeout(*(previous || [0, false]))
+            end
         end
 
         # @deprecated use {Orocos.load_typekit} instead
@@ -110,12 +148,64 @@ def self.clear
             @name_service = nil
         end
 
+        # Runs a block on each of the given objects concurrently
+        #
+        # The CORBA calls done within the block release the GVL, so running
+        # the blocks from several threads overlaps their round trips. At most
+        # +max_concurrency+ blocks run at the same time.
+        #
+        # @example read the model name of many tasks
+        #   Orocos::CORBA.parallel(tasks) { |t| t.getModelName }
+        #
+        # @param [Array] objects
+        # @param [Integer] max_concurrency
+        # @yieldparam [Object] object an element of +objects+
+        # @return [Array] the block's return values, in the order of
+        #   +objects+
+        # @raise [ParallelCallFailed] if some of the blocks raised. The
+        #   exception is raised after all the blocks finished
+        def self.parallel(objects, max_concurrency: 8)
+            objects = objects.to_a
+            queue = Queue.new
+            objects.each_with_index { |obj, i| queue << [obj, i] }
+
+            results = Array.new(objects.size)
+            errors = Hash.new
+            mutex = Mutex.new
+            threads = (0...[max_concurrency, objects.size].min).map do
+                Thread.new do
+                    while (item = (queue.pop(true) rescue nil))
+                        obj, i = *item
+                        begin
+                            results[i] = yield(obj)
+                        rescue Exception => e
+                            mutex.synchronize { errors[obj] = e }
+                        end
+                    end
+                end
+            end
+            threads.each(&:join)
+
+            if !errors.empty?
+                raise ParallelCallFailed.new(errors)
+            end
+            results
+        end
+
         # Improves exception messages for exceptions that are raised from the
         # C++ extension
         def self.refine_exceptions(obj0, obj1 = nil) # :nodoc:
             yield
 
         rescue ComError => e
+            [obj0, obj1].each do |obj|
+                if !obj.kind_of?(::Orocos::TaskContextBase) && obj.respond_to?(:task)
+                    obj = obj.task
+                end
+                if obj.kind_of?(::Orocos::TaskContext)
+                    ::Orocos::TaskContext.invalidate_references(obj.ior)
+                end
+            end
             if !obj1
                 raise ComError, "Communication failed with corba #{obj0}", e.backtrace
             else
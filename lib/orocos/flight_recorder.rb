@@ -0,0 +1,180 @@
+module Orocos
+    # Keeps the last samples of a set of output ports in memory
+    #
+    # Each recorded port gets connected to an input port of a local ruby
+    # task. A native thread reads these ports as soon as they receive new data
+    # and marshals the samples, along with their reception time, into a
+    # preallocated ring buffer per port. There is no Ruby involvement per
+    # sample: the rings are only converted when {#samples} or {#dump} get
+    # called, e.g. to get post-mortem data after an incident.
+    #
+    # @example keep the last 1000 samples of a port and dump them on error
+    #   recorder = Orocos::FlightRecorder.new
+    #   recorder.record(task.port('pose'), capacity: 1000)
+    #   ...
+    #   recorder.dump('incident', window: 10)
+    #
+    # Instances are created either with {FlightRecorder.new}, which creates
+    # a dedicated ruby task, or with
+    # {RubyTasks::TaskContext#create_flight_recorder}
+    class FlightRecorder
+        @recorder_count = 0
+
+        class << self
+            # Used to generate unique task names
+            attr_accessor :recorder_count
+        end
+
+        # Creates a recorder on a new ruby task
+        #
+        # @param [String] name the name of the ruby task
+        # @return [FlightRecorder]
+        def self.new(name: nil)
+            name ||= "orocosrb_#{::Process.pid}_flight_recorder_#{self.recorder_count += 1}"
+            task = RubyTasks::TaskContext.new(name)
+            recorder = task.create_flight_recorder
+            recorder.owns_task = true
+            recorder
+        rescue ::Exception
+            task.dispose if task
+            raise
+        end
+
+        # The ruby task whose input ports receive the samples
+        #
+        # @return [RubyTasks::TaskContext]
+        attr_reader :task
+
+        # Whether {#dispose} also disposes of {#task}
+        #
+        # This is the case only for the recorders created by {.new}. The task
+        # on which {RubyTasks::TaskContext#create_flight_recorder} got called
+        # belongs to the caller
+        attr_predicate :owns_task?, true
+
+        def initialize(task)
+            @task = task
+            @owns_task = false
+            @ids = Hash.new
+            @next_id = 0
+        end
+
+        # The ports that are currently recorded
+        #
+        # @return [Array<OutputPort>]
+        def recorded_ports
+            @ids.keys
+        end
+
+        # Whether the given port is recorded
+        def recording?(port)
+            @ids.has_key?(port)
+        end
+
+        # Starts recording the samples of an output port
+        #
+        # @param [OutputPort] port
+        # @param [Integer] capacity the number of samples kept for this port
+        # @param [Hash] policy the policy of the connection to the port. It
+        #   should be a buffer big enough to absorb the bursts of samples that
+        #   the recorder thread does not read fast enough
+        # @return [void]
+        def record(port, capacity: 1000, **policy)
+            if recording?(port)
+                raise ArgumentError, "already recording #{port}"
+            end
+
+            port.ensure_type_available
+            id = (@next_id += 1)
+            port_name = "recorder_#{id}"
+            do_record(id, port_name, port.type_binding, port.type.new, capacity,
+                      port.max_marshalling_size || 0)
+            begin
+                policy = { type: :buffer, size: 100 }.merge(policy)
+                port.connect_to(@task.raw_port(port_name), **policy)
+            rescue ::Exception
+                do_unrecord(id)
+                raise
+            end
+            @ids[port] = id
+            do_poll(id)
+            nil
+        end
+
+        # Stops recording an output port
+        #
+        # The samples recorded so far for this port are discarded
+        #
+        # @param [OutputPort] port
+        # @return [void]
+        def unrecord(port)
+            if id = @ids.delete(port)
+                do_unrecord(id)
+            end
+            nil
+        end
+
+        # Returns the samples recorded for a port
+        #
+        # @param [OutputPort] port
+        # @param [Float,nil] window if non-nil, only the samples received in
+        #   the last +window+ seconds are returned
+        # @return [Array<(Time,Typelib::Type)>] the reception time and the
+        #   sample, oldest first
+        def samples(port, window: nil)
+            raw_samples(port, window: window).map do |time, data|
+                [time, port.type.from_buffer(data)]
+            end
+        end
+
+        # @api private
+        #
+        # Returns the samples recorded for a port in marshalled form
+        #
+        # @return [Array<(Time,String)>]
+        def raw_samples(port, window: nil)
+            if !(id = @ids[port])
+                raise ArgumentError, "#{port} is not recorded"
+            end
+            since = Time.now - window if window
+            do_snapshot(id, since)
+        end
+
+        # Writes the recorded samples to a pocolog file
+        #
+        # Each port gets its own stream, named after the port's full name
+        #
+        # @param [String] basename the log file basename, as given to
+        #   Pocolog::Logfiles.create
+        # @param [Float,nil] window if non-nil, only the samples received in
+        #   the last +window+ seconds are written
+        # @param [Array<OutputPort>] ports the ports whose samples should be
+        #   written
+        # @return [void]
+        def dump(basename, window: nil, ports: recorded_ports)
+            if !HAS_POCOLOG
+                raise ArgumentError, "the pocolog Ruby library is not available, cannot dump the flight recorder"
+            end
+
+            logfile = Pocolog::Logfiles.create(basename)
+            begin
+                ports.each do |port|
+                    stream = logfile.create_stream(port.full_name, port.type, port.log_metadata)
+                    samples(port, window: window).each do |time, sample|
+                        stream.write(time, time, sample)
+                    end
+                end
+            ensure
+                logfile.close
+            end
+            nil
+        end
+
+        # Stops recording all the ports, and disposes of the underlying ruby
+        # task if {#owns_task?}
+        def dispose
+            recorded_ports.each { |p| unrecord(p) }
+            task.dispose if owns_task?
+        end
+    end
+end
@@ -18,16 +18,35 @@ def disconnect
         # This is only possible if the remote deployment has been started by
         # this Ruby instance
         def write(data)
+            verify_remote_end_alive
+            if !super
+                raise CORBA::ComError, "remote end was disconnected"
+            else true
+            end
+        end
+
+        # Write a sequence of samples on the associated input port
+        #
+        # @raise (see #write)
+        # @see RubyTasks::LocalOutputPort#write_batch
+        def write_batch(samples)
+            verify_remote_end_alive
+            if !super
+                raise CORBA::ComError, "remote end was disconnected"
+            else true
+            end
+        end
+
+        # @api private
+        #
+        # Disconnects and raises if the remote process is known to be dead
+        def verify_remote_end_alive
 	    if process = port.task.process
 		if !process.alive?
 		    disconnect_all
 		    raise CORBA::ComError, "remote end is dead"
 		end
 	    end
-            if !super
-                raise CORBA::ComError, "remote end was disconnected"
-            else true
-            end
         end
     end
 end
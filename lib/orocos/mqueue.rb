@@ -43,7 +43,9 @@ class << self
             #   have been used on resp. the port object or the model that describes
             #   it.
             # * it is known that the two involved tasks are on the same host (this
-            #   is possible only if orocos.rb is used to start the processes)
+            #   is possible only if orocos.rb is used to start the processes).
+            #   This includes the readers and writers created from Ruby on the
+            #   ports of such tasks, see {PortBase.ruby_task_on_same_host?}
             #
             # It is false by default. Additionally, the Orocos::MQueue.warn?
             # predicate tells if a warning should be used for connections that can't
@@ -122,12 +124,60 @@ def auto=(value)
             #
             # If false, an exception is generated instead.
             attr_predicate :auto_fallback_to_corba?, true
+
+            ##
+            # :method:adaptive_sizes?
+            # :call-seq:
+            #   Orocos::MQueue.adaptive_sizes? => true or false
+            #   Orocos::MQueue.adaptive_sizes = new_value
+            #
+            # Controls whether orocos.rb should use the observed sample sizes
+            # for the ports whose maximum marshalling size cannot be computed
+            # (i.e. types with variable-size containers for which max_sizes
+            # has not been declared).
+            #
+            # If true, {Port#handle_mq_transport} uses the size registered in
+            # {.size_profile} for such ports instead of falling back to CORBA.
+            # Moreover, readers created from Ruby on these ports start on
+            # CORBA, measure the samples they receive during
+            # {.adaptive_warmup} samples and then re-create their connection
+            # on MQ. Samples that are in flight during the switch are lost,
+            # see {OutputReader#size_profiling?}
+            #
+            # It is false by default
+            attr_predicate :adaptive_sizes?, true
+
+            # The number of samples that readers measure before switching to
+            # MQ when {.adaptive_sizes?} is set
+            #
+            # @return [Integer]
+            attr_accessor :adaptive_warmup
+
+            # The factor applied on the largest observed sample size to get
+            # the data_size of adaptive connections
+            #
+            # Since the RTT drops the samples that do not fit in the message
+            # queue, it should leave enough room for the size variations of
+            # the samples
+            #
+            # @return [Float]
+            attr_accessor :adaptive_size_margin
+
+            # The largest observed marshalled sample size, in bytes, per port
+            # full name
+            #
+            # @return [Hash<String,Integer>]
+            attr_reader :size_profile
         end
         @auto           = false
         @auto_sizes     = available?
         @validate_sizes = available?
         @warn           = true
         @auto_fallback_to_corba = true
+        @adaptive_sizes = false
+        @adaptive_warmup = 10
+        @adaptive_size_margin = 1.5
+        @size_profile = Hash.new
 
         # Verifies that the given buffer size (in samples) and sample size (in
         # bytes) are below the limits defined in /proc
@@ -154,6 +204,66 @@ def self.valid_sizes?(buffer_size, data_size)
             return true
         end
 
+        # Registers the marshalled size of a sample from the given port
+        #
+        # Only the largest size is kept
+        #
+        # @param [PortBase] port
+        # @param [Integer] size the marshalled size in bytes
+        # @return [Integer] the largest size known so far for this port
+        def self.record_sample_size(port, size)
+            current = size_profile[port.full_name]
+            if !current || current < size
+                size_profile[port.full_name] = size
+            else current
+            end
+        end
+
+        # Returns the message size that should be used for an adaptive
+        # connection from the given port, based on {.size_profile}
+        #
+        # @param [PortBase] port
+        # @return [Integer,nil] the size, or nil if no samples from this port
+        #   have been measured
+        def self.profiled_size(port)
+            if size = size_profile[port.full_name]
+                (size * adaptive_size_margin).ceil
+            end
+        end
+
+        # Loads a size profile saved with {.save_size_profile}
+        #
+        # The loaded sizes are merged into {.size_profile}, keeping the
+        # largest value for the ports that are already profiled
+        #
+        # @param [String] path
+        # @return [void]
+        def self.load_size_profile(path)
+            profile = YAML.load(File.read(path)) || Hash.new
+            if !profile.kind_of?(Hash)
+                raise ArgumentError, "#{path} does not contain a size profile"
+            end
+            profile.each do |port_name, size|
+                size = Integer(size)
+                if !(current = size_profile[port_name]) || current < size
+                    size_profile[port_name] = size
+                end
+            end
+            nil
+        end
+
+        # Saves {.size_profile} in YAML format, so that the measurements can
+        # be reused by later runs
+        #
+        # @param [String] path
+        # @return [void]
+        def self.save_size_profile(path)
+            File.open(path, 'w') do |io|
+                io.write YAML.dump(size_profile)
+            end
+            nil
+        end
+
         # Returns the maximum message queue size, in the number of samples
         def self.msg_max
             if !@msg_max.nil?
@@ -600,6 +600,73 @@ def names
                 map_to_namespace(result)
             end
 
+            # Enables a client-side cache of the task names and IORs
+            #
+            # A background thread then fetches all the IORs from the name
+            # service every refresh_period seconds, and {#names}, {#iors} and
+            # {#ior} are answered from memory. {#ior} still asks the name
+            # service for tasks that are not in the cache yet. If the cache
+            # could not be refreshed for more than ttl seconds, the calls go
+            # to the name service again.
+            #
+            # The names that got added or removed by the refreshes are
+            # reported by {#cache_changes}
+            #
+            # @param [Float] ttl how long, in seconds, a refresh stays valid
+            # @param [Float] refresh_period the period, in seconds, of the
+            #   refreshes. It must be strictly positive
+            # @param [Integer] batch_size how many names are fetched from the
+            #   name service at a time by the refreshes, see {#iors}
+            # @param [Integer] max_concurrency how many names are resolved at
+            #   the same time by the refreshes, see {#iors}
+            # @return [void]
+            def enable_cache(ttl: 5, refresh_period: 1, batch_size: 100, max_concurrency: 8)
+                if refresh_period <= 0
+                    raise ArgumentError, "the cache refresh period must be strictly positive, got #{refresh_period}"
+                elsif ttl < refresh_period
+                    raise ArgumentError, "the cache TTL (#{ttl}) must be greater than its refresh period (#{refresh_period})"
+                end
+                do_enable_cache(ttl, refresh_period, batch_size, max_concurrency)
+            end
+
+            # Disables the cache enabled by {#enable_cache}
+            def disable_cache
+                do_disable_cache
+            end
+
+            # Returns the tasks that got registered or deregistered since the
+            # last call
+            #
+            # It is only available if the cache is enabled, see
+            # {#enable_cache}
+            #
+            # @return [(Array<String>,Array<String>)] the names of the added
+            #   and removed tasks
+            def cache_changes
+                added, removed = do_cache_changes
+                return map_to_namespace(added.find_all { |n| n !~ /^orocosrb_(\d+)$/ }),
+                    map_to_namespace(removed.find_all { |n| n !~ /^orocosrb_(\d+)$/ })
+            end
+
+            # Returns the IORs of all the tasks registered on the name service
+            #
+            # It is equivalent to calling {#ior} on each of {#names}, but the
+            # names are listed in large batches and resolved concurrently
+            #
+            # @param [Integer] batch_size how many names are fetched from the
+            #   name service at a time
+            # @param [Integer] max_concurrency how many names are resolved at
+            #   the same time
+            # @return [Hash<String,String>] the IOR of each task, indexed by
+            #   the task name (including the namespace)
+            def iors(batch_size: 100, max_concurrency: 8)
+                result = CORBA.refine_exceptions("corba naming service(#{ip})") do
+                    do_iors(batch_size, max_concurrency).find_all { |n, _| n !~ /^orocosrb_(\d+)$/ }
+                end
+                names = map_to_namespace(result.map(&:first))
+                Hash[names.zip(result.map(&:last))]
+            end
+
             # (see NameServiceBase#get)
             def get(name = nil, namespace: nil, process: nil, ior: nil)
                 if ior
@@ -4,6 +4,9 @@ module Orocos
     class SendHandle
         attr_reader :orocos_return_types
         attr_reader :return_values
+        # The type bindings for the return values, as given by
+        # {Operation#return_type_bindings}
+        attr_reader :return_type_bindings
 
         # Waits for the operation to finish and returns both its completion
         # status and, if applicable, its return value(s)
@@ -15,7 +18,7 @@ class SendHandle
         #   Orocos::SEND_FAILURE
         def collect
             CORBA.refine_exceptions(self) do
-                status = do_operation_collect(orocos_return_types, return_values)
+                status = do_operation_collect(return_type_bindings, return_values)
                 if return_values.empty?
                     return status
                 else
@@ -36,7 +39,7 @@ def collect
         # remote task)
         def collect_if_done
             CORBA.refine_exceptions(self) do
-                status = do_operation_collect_if_done(orocos_return_types, return_values)
+                status = do_operation_collect_if_done(return_type_bindings, return_values)
                 if return_values.empty?
                     return status
                 else
@@ -78,6 +81,16 @@ class Operation
 
         attr_reader :inout_arguments
 
+        # The timeout of the calls to this operation, in milliseconds
+        #
+        # If set, {#callop} and {#sendop} are done within
+        # {CORBA.with_call_timeout}, which allows to bound the time spent
+        # calling a latency-critical operation without affecting the other
+        # calls. The default (nil) uses the task and global timeouts.
+        #
+        # @return [Integer,nil]
+        attr_accessor :call_timeout
+
         def initialize(task, name, return_spec, arguments_spec)
             @task, @name, @return_spec, @arguments_spec =
                 task, name, return_spec, arguments_spec
@@ -121,6 +134,38 @@ def typelib_types_for(types)
             end
         end
 
+        # The bindings of {#orocos_return_typenames} in the RTT type system
+        #
+        # @return [Array<TypeBinding>]
+        def return_type_bindings
+            @return_type_bindings ||= orocos_return_typenames.map do |type_name|
+                Orocos.type_binding_for(type_name)
+            end
+        end
+
+        # The bindings of {#orocos_arguments_typenames} in the RTT type system
+        #
+        # @return [Array<TypeBinding>]
+        def arguments_type_bindings
+            @arguments_type_bindings ||= orocos_arguments_typenames.map do |type_name|
+                Orocos.type_binding_for(type_name)
+            end
+        end
+
+        # Returns the native call site for this operation
+        #
+        # The call site holds the type bindings of the return value and
+        # arguments as well as a CORBA argument buffer, which are then reused
+        # by all the calls made through {#callop} and {#sendop}
+        #
+        # @return [OperationCallSite]
+        def compile
+            @call_site ||= CORBA.refine_exceptions(self) do
+                return_binding = return_type_bindings[0] if !@void_return
+                task.do_operation_compile(name, return_binding, arguments_type_bindings)
+            end
+        end
+
         # Returns a new Typelib value for the Nth argument
         def new_argument(index)
             arguments_types[index].new
@@ -137,7 +182,11 @@ def common_call(args) # :nodoc:
                 filtered << Typelib.from_ruby(v, arguments_types[i])
             end
             CORBA.refine_exceptions(self) do
-                yield(filtered)
+                if call_timeout
+                    CORBA.with_call_timeout(call_timeout) { yield(filtered) }
+                else
+                    yield(filtered)
+                end
             end
         end
 
@@ -161,9 +210,10 @@ def new_result
         # to query the operation status and return value
         def sendop(*args)
             common_call(args) do |filtered|
-                handle = task.do_operation_send(name, orocos_arguments_typenames, filtered)
+                handle = compile.do_send(filtered)
                 handle.instance_variable_set :@operation, self
                 handle.instance_variable_set :@orocos_return_types, @orocos_return_typenames.dup
+                handle.instance_variable_set :@return_type_bindings, return_type_bindings
                 handle.instance_variable_set :@return_values, new_result
                 handle
             end
@@ -173,14 +223,12 @@ def sendop(*args)
         # to finish. It returns the value returned by the remote method.
         def callop(*args)
             raw_result = common_call(args) do |filtered|
-                return_typename, return_value = nil
+                return_value = nil
                 if !@void_return
-                    return_typename = orocos_return_typenames[0]
                     return_value = result_value_for(return_types.first)
                 end
 
-                task.do_operation_call(name, return_typename, return_value,
-                           orocos_arguments_typenames, filtered)
+                compile.do_call(return_value, filtered)
 
                 result = []
                 if return_value
@@ -204,3 +252,93 @@ def callop(*args)
     end
 end
 
+
+module Orocos
+    # Monitors the completion of many asynchronous operation calls
+    #
+    # The handles returned by {Operation#sendop} are polled by a background
+    # C++ thread, without holding the GVL. Completed calls are queued, and
+    # Ruby gets notified through an IO object that can be used with
+    # IO.select, or with an event loop's IO watching facilities.
+    #
+    # @example
+    #   reactor = Orocos::SendHandleReactor.new
+    #   reactor.watch(task.operation('compute').sendop(42)) do |status, *result|
+    #       ...
+    #   end
+    #   loop do
+    #       reactor.wait
+    #   end
+    class SendHandleReactor
+        # The IO object that becomes readable when some calls completed
+        #
+        # @return [IO]
+        attr_reader :io
+
+        # @param [Float] period the polling period, in seconds
+        def initialize(period: 0.01)
+            @native = NativeReactor.new(period)
+            @io = IO.for_fd(@native.wakeup_fd, autoclose: false)
+            @pending = Hash.new
+            @callbacks = Hash.new
+            @next_id = 0
+        end
+
+        # The number of calls that did not complete yet
+        def pending_count
+            @pending.size
+        end
+
+        # Starts monitoring a send handle
+        #
+        # @param [SendHandle] handle
+        # @yieldparam [Integer] status the completion status, either
+        #   {SEND_SUCCESS} or {SEND_FAILURE}, or nil if the handle could not be
+        #   polled or its results could not be converted
+        # @yieldparam [Array] results the values returned by the operation if
+        #   the status is {SEND_SUCCESS}, or the exception that was raised
+        #   while polling the handle or converting its results if the status
+        #   is nil
+        # @return [void]
+        def watch(handle, &block)
+            id = (@next_id += 1)
+            @pending[id] = handle
+            @callbacks[id] = block
+            @native.do_watch(id, handle)
+        end
+
+        # Processes the calls that completed so far, calling the watch
+        # callbacks
+        #
+        # @return [Integer] the number of completed calls
+        def process
+            completed = @native.do_drain(@pending)
+            completed.each do |id, status, exception|
+                handle = @pending.delete(id)
+                callback = @callbacks.delete(id)
+                next if !callback
+
+                if exception
+                    callback.call(nil, exception)
+                elsif status == SEND_SUCCESS
+                    callback.call(status, *handle.return_values)
+                else
+                    callback.call(status)
+                end
+            end
+            completed.size
+        end
+
+        # Waits for calls to complete and processes them
+        #
+        # @param [Float,nil] timeout how long to wait for. Waits forever if
+        #   nil
+        # @return [Integer] the number of completed calls
+        def wait(timeout = nil)
+            if IO.select([io], nil, nil, timeout)
+                process
+            else 0
+            end
+        end
+    end
+end
@@ -14,6 +14,23 @@ def pretty_print(pp) # :nodoc:
         # should be used
         def self.reader_class; OutputReader end
 
+        # Returns an {OutputReader} object that is connected to this port
+        #
+        # If the connection could use the MQ transport but the sample size is
+        # unknown (see {#adaptive_mq_size?}), the reader starts on CORBA and
+        # switches to MQ once it measured the size of the samples, see
+        # {OutputReader#size_profiling?}
+        def reader(distance: D_UNKNOWN, **policy)
+            reader = super
+            if distance == D_UNKNOWN
+                distance = distance_to(reader)
+            end
+            if distance == D_SAME_HOST && adaptive_mq_size?(policy)
+                reader.start_size_profiling(distance)
+            end
+            reader
+        end
+
         # Connect this output port to an input port. +options+ defines the
         # connection policy for the connection. If a task is given instead of
         # an input port the method will try to find the right input port
@@ -42,6 +59,32 @@ def connect_to(input_port, distance: D_UNKNOWN, **options)
                 return super
             end
 
+            input_port, policy = prepare_connection(input_port, distance: distance, **options)
+            begin
+                refine_exceptions(input_port) do
+                    do_connect_to(input_port, policy)
+                end
+            rescue Orocos::ConnectionFailed => e
+                if policy[:transport] == TRANSPORT_MQ && Orocos::MQueue.auto_fallback_to_corba?
+                    policy[:transport] = TRANSPORT_CORBA
+                    Orocos.warn "failed to create a connection from #{full_name} to #{input_port.full_name} using the MQ transport, falling back to CORBA"
+                    retry
+                end
+                raise
+            end
+                    
+            self
+        rescue Orocos::ConnectionFailed => e
+            raise e, "failed to connect #{full_name} => #{input_port.full_name} with policy #{policy.inspect}"
+        end
+
+        # Validates a connection to an input port and computes its policy
+        #
+        # @param [#to_orocos_port] input_port
+        # @return [(InputPort,Hash)] the input port and the connection policy
+        #   as expected by the C extension
+        # @raise [ArgumentError] if the ports cannot be connected
+        def prepare_connection(input_port, distance: D_UNKNOWN, **options)
             input_port = input_port.to_orocos_port
             if !input_port.kind_of?(InputPort)
                 raise ArgumentError, "an output port can only connect to an input port (got #{input_port})"
@@ -59,23 +102,7 @@ def connect_to(input_port, distance: D_UNKNOWN, **options)
             if policy[:pull]
                 input_port.blocking_read = true
             end
-
-            begin
-                refine_exceptions(input_port) do
-                    do_connect_to(input_port, policy)
-                end
-            rescue Orocos::ConnectionFailed => e
-                if policy[:transport] == TRANSPORT_MQ && Orocos::MQueue.auto_fallback_to_corba?
-                    policy[:transport] = TRANSPORT_CORBA
-                    Orocos.warn "failed to create a connection from #{full_name} to #{input_port.full_name} using the MQ transport, falling back to CORBA"
-                    retry
-                end
-                raise
-            end
-                    
-            self
-        rescue Orocos::ConnectionFailed => e
-            raise e, "failed to connect #{full_name} => #{input_port.full_name} with policy #{policy.inspect}"
+            return input_port, policy
         end
 
         # Require this port to disconnect from the provided input port
@@ -90,5 +117,109 @@ def disconnect_from(input)
             end
         end
     end
+
+    # Creates many connections at once
+    #
+    # The connections are created concurrently, which costs roughly one
+    # round trip per +max_concurrency+ connections instead of one per
+    # connection. Connections that failed with the MQ transport are retried
+    # with CORBA as in {OutputPort#connect_to}.
+    #
+    # @example
+    #   Orocos.connect_all([[source.out, sink.in, type: :buffer, size: 10],
+    #                       [source.status, monitor.status]])
+    #
+    # @param [Array<(OutputPort,InputPort,Hash)>] connections the
+    #   connections, with an optional policy as accepted by
+    #   {OutputPort#connect_to}
+    # @param [Boolean] rollback if true, the connections that got created are
+    #   removed if some other ones failed. Since RTT cannot tell whether two
+    #   given ports were already connected, only the connections whose input
+    #   port had no connection at all before the call are removed. The
+    #   entries of the removed connections in the returned hash are
+    #   :rolled_back, and the ones whose removal failed are the
+    #   corresponding exception
+    # @param [Boolean] raise_on_error if true, a {ParallelCallFailed} is
+    #   raised if some connections failed. Otherwise, the corresponding
+    #   entries of the returned hash are the exceptions
+    # @param [Integer] max_concurrency
+    # @return [Hash<(OutputPort,InputPort),(true,:rolled_back,Exception)>]
+    #   the result of each connection
+    def self.connect_all(connections, rollback: false, raise_on_error: true, max_concurrency: 8)
+        prepared = connections.map do |output_port, input_port, policy|
+            input_port, policy = output_port.prepare_connection(input_port, **(policy || Hash.new))
+            [output_port, input_port, policy]
+        end
+
+        if rollback
+            input_ports = prepared.map { |_, input_port, _| input_port }.uniq
+            was_connected = CORBA.parallel(input_ports, max_concurrency: max_concurrency) do |input_port|
+                begin input_port.connected?
+                rescue StandardError
+                    # Be conservative, we must not remove a connection that
+                    # existed before
+                    true
+                end
+            end
+            was_connected = Hash[input_ports.zip(was_connected)]
+        end
+
+        results = Hash.new
+        pending = prepared
+        while !pending.empty?
+            values = CORBA.refine_exceptions("connections") do
+                OutputPort.do_connect_all(pending, max_concurrency)
+            end
+
+            retries = Array.new
+            pending.each_with_index do |(output_port, input_port, policy), i|
+                value = values[i]
+                if value == false
+                    value = ConnectionFailed.new("failed to connect #{output_port.full_name} => #{input_port.full_name} with policy #{policy.inspect}")
+                end
+
+                if value.kind_of?(ConnectionFailed) && policy[:transport] == TRANSPORT_MQ && Orocos::MQueue.auto_fallback_to_corba?
+                    Orocos.warn "failed to create a connection from #{output_port.full_name} to #{input_port.full_name} using the MQ transport, falling back to CORBA"
+                    retries << [output_port, input_port, policy.merge(transport: TRANSPORT_CORBA)]
+                else
+                    if value.kind_of?(CORBA::ComError)
+                        [output_port.task, input_port.task].each do |t|
+                            TaskContext.invalidate_references(t.ior) if t.kind_of?(TaskContext)
+                        end
+                    end
+                    results[[output_port, input_port]] = value
+                end
+            end
+            pending = retries
+        end
+
+        errors = results.find_all { |_, value| value.kind_of?(Exception) }
+        if errors.empty?
+            return results
+        end
+
+        if rollback
+            connected = results.find_all do |(_, input_port), value|
+                value == true && !was_connected[input_port]
+            end.map(&:first)
+            removed = CORBA.refine_exceptions("connections") do
+                OutputPort.do_disconnect_pairs(connected, max_concurrency)
+            end
+            connected.each_with_index do |(output_port, input_port), i|
+                value = removed[i]
+                if value == true
+                    value = :rolled_back
+                elsif value == false
+                    value = ConnectionFailed.new("failed to remove #{output_port.full_name} => #{input_port.full_name} while rolling back")
+                end
+                results[[output_port, input_port]] = value
+            end
+            errors = results.find_all { |_, value| value.kind_of?(Exception) }
+        end
+        if raise_on_error
+            raise ParallelCallFailed.new(Hash[errors])
+        end
+        results
+    end
 end
 
@@ -57,6 +57,149 @@ def read_new(sample = nil)
             end
         end
 
+        # Reads a sample on the associated output port and returns only the
+        # given field
+        #
+        # @raise [CORBA::ComError] if the remote process is known to be dead.
+        # This is only possible if the remote deployment has been started by
+        # this Ruby instance
+        # @see RubyTasks::LocalInputPort#read_field
+        def read_field(projection)
+            if !policy[:pull]
+                Orocos.allow_blocking_calls do
+                    # Non-pull readers are non-blocking
+                    super
+                end
+            else
+                super
+            end
+        end
+
+        # Reads a new sample on the associated output port and returns only
+        # the given field
+        #
+        # @raise [CORBA::ComError] if the remote process is known to be dead.
+        # This is only possible if the remote deployment has been started by
+        # this Ruby instance
+        # @see RubyTasks::LocalInputPort#read_new_field
+        def read_new_field(projection)
+            if !policy[:pull]
+                Orocos.allow_blocking_calls do
+                    # Non-pull readers are non-blocking
+                    super
+                end
+            else
+                super
+            end
+        end
+
+        # Reads all the new samples available on the associated output port,
+        # up to a limit
+        #
+        # @raise [CORBA::ComError] if the remote process is known to be dead.
+        # This is only possible if the remote deployment has been started by
+        # this Ruby instance
+        # @see RubyTasks::LocalInputPort#read_new_batch
+        def raw_read_new_batch(max_samples, samples = nil)
+            samples =
+                if !policy[:pull]
+                    Orocos.allow_blocking_calls do
+                        # Non-pull readers are non-blocking
+                        super
+                    end
+                else
+                    super
+                end
+
+            if size_profiling?
+                profile_sample_sizes(samples, samples.size < max_samples)
+            end
+            samples
+        end
+
+        # Overloaded to measure the received samples while {#size_profiling?}
+        def raw_read_with_result(sample = nil, copy_old_data = true)
+            ret = super
+            if size_profiling?
+                result, value = ret
+                if result == NEW_DATA
+                    profile_sample_sizes([value], false)
+                else
+                    profile_sample_sizes([], true)
+                end
+            end
+            ret
+        end
+
+        # Whether this reader measures the samples it receives to switch its
+        # connection to the MQ transport
+        #
+        # The connection is re-created once {MQueue.adaptive_warmup} samples
+        # have been measured, on a read that found no new data so that the
+        # samples already received are not lost. The data size is computed
+        # from {MQueue.size_profile} and validated as for any other MQ
+        # connection (i.e. the connection stays on CORBA if the samples are
+        # too big for the system's limits)
+        #
+        # The CORBA connection is removed before the MQ one gets created, as
+        # the samples would otherwise be delivered on both. The samples written
+        # between the removal and the creation of the MQ connection, as well
+        # as the ones that arrived in the CORBA connection after that last
+        # read, are lost. If the MQ connection cannot be created, the reader
+        # is connected over CORBA again
+        #
+        # @see MQueue.adaptive_sizes?
+        def size_profiling?
+            !!@profiled_samples
+        end
+
+        # Starts measuring the received samples
+        #
+        # This is called by {OutputPort#reader}
+        #
+        # @param [Integer] distance the distance between the port and this
+        #   reader, as returned by {PortBase#distance_to}
+        def start_size_profiling(distance)
+            @profiled_samples = 0
+            @profiling_distance = distance
+        end
+
+        # @api private
+        #
+        # Registers the size of received samples and switches to MQ once the
+        # warmup is finished
+        #
+        # @param [Array<Typelib::Type>] samples the newly received samples
+        # @param [Boolean] drained whether there are no more samples to read
+        def profile_sample_sizes(samples, drained)
+            samples.each do |s|
+                Orocos::MQueue.record_sample_size(port, s.to_byte_array.bytesize)
+            end
+            @profiled_samples += samples.size
+            if drained && @profiled_samples >= Orocos::MQueue.adaptive_warmup
+                @profiled_samples = nil
+                switch_to_profiled_connection
+            end
+        end
+
+        # @api private
+        #
+        # Re-creates the connection of this reader once its samples have
+        # been profiled, falling back to CORBA if the new connection cannot
+        # be created
+        #
+        # @see size_profiling?
+        def switch_to_profiled_connection
+            disconnect_all
+            begin
+                port.connect_to(self, distance: @profiling_distance, **policy)
+            rescue Orocos::ConnectionFailed => e
+                Orocos.warn "failed to switch the reader of #{port.full_name} to the MQ transport, staying on CORBA: #{e.message}"
+                port.connect_to(self, distance: @profiling_distance,
+                                **policy.merge(transport: TRANSPORT_CORBA))
+            end
+        end
+
         # Disconnects this port from the port it is reading
         def disconnect
             disconnect_all
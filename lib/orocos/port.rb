@@ -45,6 +45,17 @@ def self.transport_name(id)
         # Returns the name of the typelib type. Use #type.name instead.
         def type_name; type.name end
 
+        # The binding of {#orocos_type_name} in the RTT type system
+        #
+        # The binding object is private to this object, as it keeps the
+        # marshalling handles used to convert opaque types between calls
+        #
+        # @return [TypeBinding]
+        # @see Orocos.type_binding_for
+        def type_binding
+            @type_binding ||= Orocos.type_binding_for(orocos_type_name)
+        end
+
         def pretty_print(pp) # :nodoc:
             if type.name != orocos_type_name
                 pp.text " #{name} (#{type.name}/#{orocos_type_name})"
@@ -182,6 +193,22 @@ class InvalidMQTransportSetup < ArgumentError; end
 
         MQ_RTT_DEFAULT_QUEUE_LENGTH = 10
 
+        # Whether a connection with the given policy would use the MQ
+        # transport, if only the size of the samples was known
+        #
+        # This is the case if {MQueue.adaptive_sizes?} is set, the transport
+        # is selected automatically and neither the policy, {#max_sizes} nor
+        # {MQueue.size_profile} give the sample size
+        def adaptive_mq_size?(policy)
+            Orocos::MQueue.auto? &&
+                Orocos::MQueue.auto_sizes? &&
+                Orocos::MQueue.adaptive_sizes? &&
+                (policy[:transport] || 0) == 0 &&
+                (policy[:data_size] || 0) == 0 &&
+                !max_marshalling_size &&
+                !Orocos::MQueue.profiled_size(self)
+        end
+
         # Helper method for #connect_to, to handle the MQ transport (in
         # particular, the validation of the parameters)
         #
@@ -217,6 +244,13 @@ def handle_mq_transport(input_name, policy) # :nodoc:
 
             if Orocos::MQueue.auto_sizes? && message_size == 0
                 size = max_marshalling_size
+                if !size && Orocos::MQueue.adaptive_sizes?
+                    if size = Orocos::MQueue.profiled_size(self)
+                        Orocos.info do
+                            "#{full_name} => #{input_name}: using the profiled sample size"
+                        end
+                    end
+                end
                 if !size
                     if policy[:transport] == TRANSPORT_MQ
                         raise InvalidMQTransportSetup, "MQ transport explicitely selected, but the message size cannot be computed for #{self}"
@@ -32,6 +32,18 @@ def initialize(task, name, orocos_type_name, model)
             super() if defined? super
         end
 
+        # The metadata that describes this port in a log stream
+        #
+        # @return [Hash<String,String>]
+        def log_metadata
+            Hash['rock_task_model' => ((task.model && task.model.name) || ''),
+                'rock_task_name' => task.name,
+                'rock_task_object_name' => name,
+                'rock_orocos_type_name' => orocos_type_name,
+                'rock_cxx_type_name' => orocos_type_name,
+                'rock_stream_type' => 'port']
+        end
+
         D_UNKNOWN      = 0
         D_SAME_PROCESS = 1
         D_SAME_HOST    = 2
@@ -42,6 +54,9 @@ def initialize(task, name, orocos_type_name, model)
         # @return one of the D_ constants
         def distance_to(input_port)
             if !task.process || !input_port.task.process
+                if PortBase.ruby_task_on_same_host?(task, input_port.task)
+                    return D_SAME_HOST
+                end
                 return D_UNKNOWN
             elsif task.process == input_port.task.process
                 return D_SAME_PROCESS
@@ -51,6 +66,27 @@ def distance_to(input_port)
             end
         end
 
+        # Whether one of the two tasks is {Orocos.ruby_task} and the other one
+        # is known to run on the local host
+        #
+        # {Orocos.ruby_task} holds the ports created by
+        # {OutputPortBase#reader} and {InputPortBase#writer}. It has no process,
+        # but lives in this Ruby process. Knowing that the connection is local
+        # allows the readers and writers to use a same-host transport (see
+        # {MQueue.auto?}) instead of CORBA.
+        def self.ruby_task_on_same_host?(task, other_task)
+            ruby_task = Orocos.ruby_task
+            return false if !ruby_task
+
+            if task.equal?(ruby_task)
+                remote = other_task
+            elsif other_task.equal?(ruby_task)
+                remote = task
+            else return false
+            end
+            (process = remote.process) && process.on_localhost?
+        end
+
         def to_s
             "#{full_name}"
         end
@@ -8,3 +8,5 @@ module RubyTasks
 
 require 'orocos/ruby_tasks/task_context'
 require 'orocos/ruby_tasks/ports'
+require 'orocos/ruby_tasks/input_port_group'
+require 'orocos/ruby_tasks/field_projection'
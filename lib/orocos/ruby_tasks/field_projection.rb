@@ -0,0 +1,79 @@
+module Orocos
+    module RubyTasks
+    # Extracts a single field out of samples of a given type
+    #
+    # The location of the field is resolved once, natively, so that
+    # extracting it does not convert the rest of the sample to Ruby. Numeric
+    # fields are returned directly as Ruby numbers.
+    #
+    # Only the fields that are at a fixed offset in the sample can be
+    # projected, i.e. the path may only go through structs and static arrays
+    #
+    # @example read the x coordinate of a pose
+    #   projection = reader.field_projection(['position', 'data', 0])
+    #   x = reader.read_new_field(projection)
+    class FieldProjection
+        # The type of the samples the field is extracted from
+        #
+        # @return [Class<Typelib::Type>]
+        attr_reader :type
+
+        # The path to the field, as field names and array indexes
+        #
+        # @return [Array<String,Integer>]
+        attr_reader :path
+
+        # The type of the field
+        #
+        # @return [Class<Typelib::Type>]
+        attr_reader :field_type
+
+        # A sample of {#type}, used by {LocalInputPort#read_field} to avoid
+        # allocating a sample per read
+        #
+        # @return [Typelib::Type]
+        attr_reader :buffer
+
+        # @param [Typelib::Type] buffer a sample of the projected type
+        # @param [Array<String,Integer>] path
+        # @raise [ArgumentError] if the path does not exist or goes through a
+        #   container
+        def initialize(buffer, path)
+            @buffer = buffer
+            @type = buffer.class
+            @path = path
+            @field_type = path.inject(type) do |t, field|
+                if field.kind_of?(Integer) then t.deference
+                else t[field]
+                end
+            end
+        end
+
+        # Whether {#extract} returns the field as a Ruby number without
+        # going through a typelib value
+        def numeric_field?
+            (field_type <= Typelib::NumericType) && field_type.name != '/bool'
+        end
+
+        # Returns the field of the given sample as a typelib value
+        #
+        # @param [Typelib::Type] sample a sample of {#type}
+        # @return [Typelib::Type] a copy of the field
+        def raw_extract(sample)
+            do_extract(sample, field_type.new)
+        end
+
+        # Returns the field of the given sample converted to Ruby
+        #
+        # @param [Typelib::Type] sample a sample of {#type}
+        # @return [Object]
+        def extract(sample)
+            if numeric_field?
+                do_extract(sample, nil)
+            else
+                Typelib.to_ruby(raw_extract(sample))
+            end
+        end
+    end
+    end
+end
@@ -0,0 +1,110 @@
+module Orocos
+    module RubyTasks
+    # Waits for new data on many local input ports at once
+    #
+    # The ports' new-data callbacks write to a pipe, so that {#io} becomes
+    # readable as soon as any of the ports receives a sample. It allows to
+    # block on a single file descriptor (e.g. with IO.select or an event
+    # loop) instead of polling every port on a timer.
+    #
+    # @example read the data of two ports as it arrives
+    #   group = Orocos::RubyTasks::InputPortGroup.new
+    #   group.add(task.in0)
+    #   group.add(task.in1)
+    #   loop do
+    #       group.wait.each do |port|
+    #           while sample = port.read_new
+    #               ...
+    #           end
+    #       end
+    #   end
+    class InputPortGroup
+        # The IO object that becomes readable when some ports received data
+        #
+        # @return [IO]
+        attr_reader :io
+
+        def initialize
+            @io = IO.for_fd(wakeup_fd, autoclose: false)
+            @ids = Hash.new
+            @ports = Hash.new
+            @next_id = 0
+        end
+
+        # The ports monitored by this group
+        #
+        # @return [Array<LocalInputPort>]
+        def ports
+            @ids.keys
+        end
+
+        # Whether this group monitors the given port
+        def include?(port)
+            @ids.has_key?(port)
+        end
+
+        # Starts monitoring a port
+        #
+        # The port is reported by the next call to {#ready_ports}, as it
+        # may have received data before being added
+        #
+        # @param [LocalInputPort] port
+        # @return [void]
+        def add(port)
+            if !port.kind_of?(LocalInputPort)
+                raise ArgumentError, "#{port} is not a local input port"
+            elsif include?(port)
+                return
+            end
+
+            id = (@next_id += 1)
+            do_add(id, port)
+            @ids[port] = id
+            @ports[id] = port
+            nil
+        end
+
+        # Stops monitoring a port
+        #
+        # @param [LocalInputPort] port
+        # @return [void]
+        def remove(port)
+            if id = @ids.delete(port)
+                @ports.delete(id)
+                do_remove(id)
+            end
+            nil
+        end
+
+        # Returns the ports that received data since the last call, without
+        # blocking
+        #
+        # The ports are not read, and might have been emptied since the
+        # notification. The caller should therefore use the non-blocking
+        # read methods (e.g. {LocalInputPort#read_new}).
+        #
+        # @return [Array<LocalInputPort>]
+        def ready_ports
+            do_drain.map { |id| @ports[id] }.compact
+        end
+
+        # Waits for some ports to receive data
+        #
+        # @param [Float,nil] timeout how long to wait for. Waits forever if
+        #   nil
+        # @return [Array<LocalInputPort>] the ports that received data, see
+        #   {#ready_ports}. It is empty if the timeout was reached
+        def wait(timeout = nil)
+            if IO.select([io], nil, nil, timeout)
+                ready_ports
+            else []
+            end
+        end
+
+        # Stops monitoring all the ports
+        def clear
+            ports.each { |p| remove(p) }
+        end
+    end
+    end
+end
@@ -1,5 +1,18 @@
 module Orocos
     module RubyTasks
+    # @api private
+    #
+    # Native object that waits for new data on a {LocalInputPort}, see
+    # {LocalInputPort#wait_new}
+    class NewDataWaiter
+        # The port this object waits on
+        attr_reader :port
+
+        def initialize(port)
+            @port = port
+        end
+    end
+
     # Input port created on a {TaskContext} task instantiated in this Ruby
     # process
     #
@@ -93,6 +106,170 @@ def raw_read_new(sample = nil)
             value
         end
 
+        # Returns an object that allows to read a single field of this port's
+        # samples with {#read_field} and {#read_new_field}
+        #
+        # @param [Array<String,Integer>] path the field names and array
+        #   indexes leading to the field
+        # @return [FieldProjection]
+        # @raise [ArgumentError] if the field is not at a fixed offset in the
+        #   samples, see {FieldProjection}
+        def field_projection(path)
+            FieldProjection.new(type.new, Array(path))
+        end
+
+        # Reads a sample on this port and returns only the given field
+        #
+        # Unlike reading the sample and accessing the field, only the field
+        # is converted to Ruby. Moreover, the same sample is reused for all
+        # the reads done with a given projection
+        #
+        # @param [FieldProjection] projection
+        # @return [Object,nil] the field value, or nil if there are no
+        #   samples on this port
+        def read_field(projection)
+            validate_field_projection(projection)
+            if value = raw_read(projection.buffer)
+                projection.extract(value)
+            end
+        end
+
+        # Reads a new sample on this port and returns only the given field
+        #
+        # @param (see #read_field)
+        # @return [Object,nil] the field value, or nil if there are no new
+        #   samples on this port
+        # @see read_field
+        def read_new_field(projection)
+            validate_field_projection(projection)
+            if value = raw_read_new(projection.buffer)
+                projection.extract(value)
+            end
+        end
+
+        # @api private
+        #
+        # Verifies that a projection applies to this port's samples
+        def validate_field_projection(projection)
+            if projection.type != type
+                raise ArgumentError, "#{projection} projects samples of type #{projection.type.name}, but #{self} is of type #{type.name}"
+            end
+        end
+
+        # Waits for a new sample on this port
+        #
+        # Unlike calling {#read_new} in a polling loop, the wait is done
+        # natively with the GVL released, and returns as soon as the port
+        # receives data. It can be interrupted as any blocking call (e.g. by
+        # Thread#raise).
+        #
+        # @param [Float,nil] timeout the maximum time to wait, in seconds.
+        #   Waits forever if nil
+        # @return [Object,nil] the new sample, or nil if the timeout was
+        #   reached
+        def wait_new(timeout = nil, sample = nil)
+            if value = raw_wait_new(timeout, sample)
+                return Typelib.to_ruby(value)
+            end
+        end
+
+        # Waits for a new sample on this port
+        #
+        # Unlike #wait_new, it will always return a typelib type even for
+        # simple types.
+        #
+        # @param (see #wait_new)
+        # @return [Typelib::Type,nil]
+        def raw_wait_new(timeout = nil, sample = nil)
+            @new_data_waiter ||= NewDataWaiter.new(self)
+            deadline = Time.now + timeout if timeout
+            loop do
+                if value = raw_read_new(sample)
+                    return value
+                end
+
+                if deadline
+                    remaining = deadline - Time.now
+                    return if remaining <= 0
+                end
+                @new_data_waiter.do_wait(remaining)
+            end
+        end
+
+        # Reads all the new samples available on this port, up to a limit
+        #
+        # Unlike calling {#read_new} repeatedly, the samples are read in a
+        # single call to the underlying port, which matters for high-rate
+        # buffered connections
+        #
+        # The samples are converted to their Ruby equivalent if a conversion
+        # has been registered
+        #
+        # @param (see #raw_read_new_batch)
+        # @return [Array] the samples read, oldest first. The array is empty
+        #   if there were no new samples
+        def read_new_batch(max_samples, samples = nil)
+            raw_read_new_batch(max_samples, samples).map do |value|
+                Typelib.to_ruby(value)
+            end
+        end
+
+        # Reads all the new samples available on this port, up to a limit
+        #
+        # Unlike {#read_new_batch}, it will always return typelib values even
+        # for simple types.
+        #
+        # @param [Integer] max_samples the maximum number of samples read
+        # @param [Array<Typelib::Type>,nil] samples samples in which the data
+        #   should be read. Passing the same array across calls avoids
+        #   allocating new samples. If it is shorter than max_samples, new
+        #   samples are allocated as needed and appended to it
+        # @return [Array<Typelib::Type>] the samples read, oldest first. They
+        #   are all new samples (i.e. the flow status is {NEW_DATA} for all of
+        #   them)
+        def raw_read_new_batch(max_samples, samples = nil)
+            samples ||= Array.new
+            samples.each do |sample|
+                if !sample.kind_of?(type)
+                    raise ArgumentError, "wrong sample type #{sample.class}, expected #{type}"
+                end
+            end
+            while samples.size < max_samples
+                samples << type.new
+            end
+
+            return [] if max_samples <= 0
+
+            # Only the first read may block. Once it returned a sample, the
+            # remaining ones are drained without releasing the GVL again
+            first, rest = samples[0, 1], samples[1, max_samples - 1]
+            count = allocating_operations(first) do
+                do_read_batch(type_binding, first, blocking_read?)
+            end
+            if count == 1 && !rest.empty?
+                count += allocating_operations(rest) do
+                    do_read_batch(type_binding, rest, false)
+                end
+            end
+            samples[0, count].each do |sample|
+                sample.invalidate_changes_from_converted_types
+            end
+        end
+
+        # @api private
+        #
+        # Yields within the allocating_operation blocks of all the given
+        # samples, since {#do_read_batch} might reallocate any of them
+        def allocating_operations(samples, index = 0, &block)
+            if index == samples.size
+                yield
+            else
+                samples[index].allocating_operation do
+                    allocating_operations(samples, index + 1, &block)
+                end
+            end
+        end
+
         # Attempt to read a sample and return it, along with the read state
         #
         # The returned sample is converted to its Ruby equivalent if a
@@ -150,7 +327,7 @@ def raw_read_with_result(sample = nil, copy_old_data = true)
             end
 
             result = value.allocating_operation do
-                do_read(orocos_type_name, value, copy_old_data, blocking_read?)
+                do_read(type_binding, value, copy_old_data, blocking_read?)
             end
             if result == NEW_DATA || (result == OLD_DATA && copy_old_data)
                 if sample
@@ -190,7 +367,20 @@ def remove
         #   input_writer.write(:field => 10, :other_field => "a_string")
         def write(data)
             data = Typelib.from_ruby(data, type)
-            do_write(orocos_type_name, data)
+            do_write(type_binding, data)
+        end
+
+        # Write a sequence of samples on this output port
+        #
+        # The samples are written in order, in a single call to the underlying
+        # port. Each sample can be given in any of the forms accepted by
+        # {#write}
+        #
+        # @param [Array] samples
+        # @return [Boolean] true if the port is connected after the write
+        def write_batch(samples)
+            samples = samples.map { |data| Typelib.from_ruby(data, type) }
+            do_write_batch(type_binding, samples)
         end
 
         # Whether the port seem to be connected to something
@@ -113,6 +113,7 @@ def remove_port(port)
             @local_ports.delete(port.name)
             port.disconnect_all # don't wait for the port to be garbage collected by Ruby
             @local_task.do_remove_port(port.name)
+            Orocos::TaskContext.port_descriptions.delete(ior)
         end
 
         # Deregisters this task context.
@@ -129,6 +130,25 @@ def exception
             @local_task.exception
         end
 
+        # Creates an object that monitors the state of other tasks through
+        # this task's input ports
+        #
+        # @param [Integer] capacity the number of state changes that can be
+        #   queued before {StateMultiplexer#process} gets called. Changes
+        #   received while the queue is full are dropped
+        # @return [StateMultiplexer]
+        def create_state_multiplexer(capacity: 1024)
+            @local_task.do_create_state_multiplexer(StateMultiplexer, capacity)
+        end
+
+        # Creates an object that records the last samples of other tasks'
+        # output ports through this task's input ports
+        #
+        # @return [FlightRecorder]
+        def create_flight_recorder
+            @local_task.do_create_flight_recorder(FlightRecorder)
+        end
+
         # Creates a new attribute on this task context
         #
         # @param [String] name the attribute name
@@ -0,0 +1,167 @@
+module Orocos
+    # Monitors the state of many tasks from a single native thread
+    #
+    # Each watched task gets its state port connected to an input port of a
+    # local ruby task. A native thread reads these ports as soon as they
+    # receive new data and queues the state changes, which are then handled
+    # in batches by {#process}. Unlike with {TaskContext#state_reader}, there
+    # is no need to poll every task: {#io} becomes readable when some states
+    # changed.
+    #
+    # @example monitor the state of all running tasks
+    #   multiplexer = Orocos::StateMultiplexer.new
+    #   tasks.each do |t|
+    #       multiplexer.watch(t) { |state, time| puts "#{t.name}: #{state}" }
+    #   end
+    #   loop { multiplexer.wait }
+    #
+    # Instances are created either with {StateMultiplexer.new}, which
+    # creates a dedicated ruby task, or with
+    # {RubyTasks::TaskContext#create_state_multiplexer}
+    class StateMultiplexer
+        @multiplexer_count = 0
+
+        class << self
+            # Used to generate unique task names
+            attr_accessor :multiplexer_count
+        end
+
+        # Creates a multiplexer on a new ruby task
+        #
+        # @param [String] name the name of the ruby task
+        # @param [Integer] capacity the number of state changes that can be
+        #   queued between two calls to {#process}. Changes received while the
+        #   queue is full are dropped, see {#dropped_count}
+        # @return [StateMultiplexer]
+        def self.new(name: nil, capacity: 1024)
+            name ||= "orocosrb_#{::Process.pid}_state_multiplexer_#{self.multiplexer_count += 1}"
+            task = RubyTasks::TaskContext.new(name)
+            multiplexer = task.create_state_multiplexer(capacity: capacity)
+            multiplexer.owns_task = true
+            multiplexer
+        rescue ::Exception
+            task.dispose if task
+            raise
+        end
+
+        # The ruby task whose input ports receive the states
+        #
+        # @return [RubyTasks::TaskContext]
+        attr_reader :task
+
+        # Whether {#dispose} also disposes of {#task}
+        #
+        # This is the case only for the multiplexers created by {.new}. The
+        # task on which {RubyTasks::TaskContext#create_state_multiplexer} got
+        # called belongs to the caller
+        attr_predicate :owns_task?, true
+
+        # The IO object that becomes readable when some states changed
+        #
+        # @return [IO]
+        attr_reader :io
+
+        def initialize(task)
+            @task = task
+            @owns_task = false
+            @io = IO.for_fd(wakeup_fd, autoclose: false)
+            @ids = Hash.new
+            @watches = Hash.new
+            @next_id = 0
+        end
+
+        # The tasks whose state is currently monitored
+        #
+        # @return [Array<TaskContext>]
+        def watched_tasks
+            @ids.keys
+        end
+
+        # Whether the state of the given task is monitored
+        def watching?(task)
+            @ids.has_key?(task)
+        end
+
+        # Starts monitoring the state of a task
+        #
+        # @param [TaskContext] task
+        # @param [Hash] policy the policy of the connection to the task's
+        #   state port
+        # @yieldparam [Symbol] state the new state
+        # @yieldparam [Time] time the time at which the state change got
+        #   received
+        # @return [void]
+        def watch(task, policy = Hash.new, &block)
+            if watching?(task)
+                raise ArgumentError, "already watching the state of #{task}"
+            end
+
+            id = (@next_id += 1)
+            port_name = "state_#{id}"
+            do_watch(id, port_name)
+            begin
+                policy = { init: true, type: :buffer, size: 10 }.merge(policy)
+                task.port('state').connect_to(@task.raw_port(port_name), **policy)
+            rescue ::Exception
+                do_unwatch(id)
+                raise
+            end
+            @ids[task] = id
+            @watches[id] = [task, block]
+            # Make sure we get the initial state even if it arrived before
+            # the connection got fully established
+            do_poll(id)
+            nil
+        end
+
+        # Stops monitoring the state of a task
+        #
+        # State changes of this task that are still queued are ignored
+        #
+        # @param [TaskContext] task
+        # @return [void]
+        def unwatch(task)
+            if id = @ids.delete(task)
+                @watches.delete(id)
+                do_unwatch(id)
+            end
+            nil
+        end
+
+        # Processes the state changes received so far, calling the watch
+        # callbacks
+        #
+        # @return [Array<(TaskContext,Symbol,Time)>] the state changes, in
+        #   the order in which they got received
+        def process
+            do_drain.map do |id, value, time|
+                task, callback = @watches[id]
+                next if !task
+
+                state = task.state_symbols[value] || value
+                callback.call(state, time) if callback
+                [task, state, time]
+            end.compact
+        end
+
+        # Waits for state changes and processes them
+        #
+        # @param [Float,nil] timeout how long to wait for. Waits forever if
+        #   nil
+        # @return [Array<(TaskContext,Symbol,Time)>] the state changes, see
+        #   {#process}
+        def wait(timeout = nil)
+            if IO.select([io], nil, nil, timeout)
+                process
+            else []
+            end
+        end
+
+        # Stops monitoring all the tasks, and disposes of the underlying ruby
+        # task if {#owns_task?}
+        def dispose
+            watched_tasks.each { |t| unwatch(t) }
+            task.dispose if owns_task?
+        end
+    end
+end
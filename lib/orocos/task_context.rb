@@ -19,6 +19,17 @@ def initialize(task, name, orocos_type_name)
             end
         end
 
+        # The binding of {#orocos_type_name} in the RTT type system
+        #
+        # The binding object is private to this object, as it keeps the
+        # marshalling handles used to convert opaque types between calls
+        #
+        # @return [TypeBinding]
+        # @see Orocos.type_binding_for
+        def type_binding
+            @type_binding ||= Orocos.type_binding_for(orocos_type_name)
+        end
+
         def do_write_dynamic(value)
             if !@dynamic_operation.callop(value)
                 raise PropertyChangeRejected, "the change of property #{name} was rejected by the remote task"
@@ -31,15 +42,15 @@ def log_metadata
             super.merge('rock_stream_type' => 'property')
         end
 
-        def do_write(type_name, value, direct: false)
+        def do_write(type_binding, value, direct: false)
             if !direct && dynamic?
                 do_write_dynamic(value)
             else
-                task.do_property_write(name, type_name, value)
+                task.do_property_write(name, type_binding, value)
             end
         end
-        def do_read(type_name, value)
-            task.do_property_read(name, type_name, value)
+        def do_read(type_binding, value)
+            task.do_property_read(name, type_binding, value)
         end
     end
 
@@ -48,15 +59,15 @@ def log_metadata
             super.merge('rock_stream_type' => 'attribute')
         end
 
-        def do_write(type_name, value, direct: false)
+        def do_write(type_binding, value, direct: false)
             if !direct && dynamic?
                 do_write_dynamic(value)
             else
-                task.do_attribute_write(name, type_name, value)
+                task.do_attribute_write(name, type_binding, value)
             end
         end
-        def do_read(type_name, value)
-            task.do_attribute_read(name, type_name, value)
+        def do_read(type_binding, value)
+            task.do_attribute_read(name, type_binding, value)
         end
     end
 
@@ -121,12 +132,154 @@ def #{m}(wait_for_completion = true, polling = 0.05)
         # @return [#log]
         attr_accessor :logger
 
+        # Description of the interface of a remote task, as returned by
+        # {#describe}
+        #
+        # The ports are not stored in the description itself, but read from
+        # the per-IOR cache of {TaskContext.port_descriptions}, so that there
+        # is a single place where they are cached and invalidated
+        #
+        # @!attribute ior
+        #   @return [String] the IOR of the described task
+        # @!attribute properties
+        #   @return [Hash<String,String>] mapping from the property names to
+        #     their type name
+        # @!attribute attributes
+        #   @return [Hash<String,String>] mapping from the attribute names to
+        #     their type name
+        # @!attribute operations
+        #   @return [Array<String>] the operation names
+        InterfaceDescription = Struct.new :ior, :properties, :attributes, :operations do
+            # @return [Hash<String,(Boolean,String)>,nil] mapping from the port
+            #   names to whether they are input ports and their type name, or
+            #   nil if the port descriptions are not cached anymore
+            def ports
+                TaskContext.port_descriptions[ior]
+            end
+        end
+
+        @interface_descriptions = Hash.new
+        @port_descriptions = Hash.new
+
+        class << self
+            # The interface descriptions resolved by {#describe}, indexed by
+            # the task IOR
+            #
+            # @return [Hash<String,InterfaceDescription>]
+            attr_reader :interface_descriptions
+
+            # The port descriptions resolved by {#port_descriptions} and
+            # {#describe}, indexed by the task IOR. This is the only cache of
+            # the port descriptions
+            #
+            # @return [Hash<String,Hash<String,(Boolean,String)>>]
+            attr_reader :port_descriptions
+        end
+
+        # Removes the cached interface description of the task with the given
+        # IOR
+        #
+        # It is called when the communication with the task fails, so that
+        # the interface is resolved again when it comes back
+        def self.invalidate_interface_description(ior)
+            interface_descriptions.delete(ior)
+            port_descriptions.delete(ior)
+        end
+
+        # Removes everything that is cached about the task with the given
+        # IOR, i.e. its interface description and the CORBA references that
+        # are shared by all the TaskContext objects created for this IOR
+        #
+        # It is called when the communication with the task fails
+        def self.invalidate_references(ior)
+            invalidate_interface_description(ior)
+            CORBA.do_invalidate_task_context(ior)
+        end
+
+        # Returns the description of the whole interface of this task
+        #
+        # The description is resolved with a few concurrent calls instead of
+        # one call per interface object, and is then cached per IOR. Once
+        # cached, it is used by {#port} and {#property} to avoid resolving the
+        # types of the interface objects.
+        #
+        # @param [Boolean] refresh if true, the description is resolved again
+        #   even if it is cached. This is needed if the interface changed,
+        #   e.g. after dynamic ports were created
+        # @return [InterfaceDescription]
+        def describe(refresh: false)
+            if !refresh && (desc = cached_interface_description)
+                # The ports are cached separately, and might have been
+                # invalidated on their own
+                port_descriptions
+                return desc
+            end
+
+            raw = CORBA.refine_exceptions(self) { do_describe }
+            ports = Hash.new
+            raw['ports'].each do |name, input, type_name|
+                ports[name] = [input, type_name]
+            end
+            TaskContext.port_descriptions[ior] = ports
+            TaskContext.interface_descriptions[ior] = InterfaceDescription.new(ior,
+                Hash[raw['properties']], Hash[raw['attributes']], raw['operations'])
+        end
+
+        # Returns the direction and type of all the ports of this task
+        #
+        # The descriptions are resolved with a single call and cached per IOR.
+        # {#raw_port} uses them instead of querying each port separately. The
+        # cache is refreshed when a port cannot be found in it, when
+        # {#port_names} reports a different number of ports, and by
+        # {#refresh_interface}.
+        #
+        # @param [Boolean] refresh if true, resolve the descriptions even if
+        #   they are cached
+        # @return [Hash<String,(Boolean,String)>] a mapping from the port
+        #   names to whether the port is an input and its type name
+        def port_descriptions(refresh: false)
+            if !refresh && (ports = TaskContext.port_descriptions[ior])
+                return ports
+            end
+
+            raw = CORBA.refine_exceptions(self) { do_port_descriptions }
+            ports = Hash.new
+            raw.each do |name, input, type_name|
+                ports[name] = [input, type_name]
+            end
+            TaskContext.port_descriptions[ior] = ports
+        end
+
+        # Discards what is cached about the interface of this task
+        #
+        # It must be called when ports or properties are known to have
+        # changed, e.g. after dynamic ports got removed.
+        #
+        # @return [void]
+        def refresh_interface
+            TaskContext.invalidate_interface_description(ior)
+            @ports.clear
+            nil
+        end
+
+        # The interface description cached by {#describe}, if there is one
+        #
+        # @return [InterfaceDescription,nil]
+        def cached_interface_description
+            TaskContext.interface_descriptions[ior]
+        end
+
         # A new TaskContext instance representing the
         # remote task context with the given IOR
         # 
         # If a remote task is only known by its name use {Orocos.name_service}
         # to create an handle to the remote task.
         #
+        # The CORBA references are cached per IOR. Creating a TaskContext
+        # checks that the remote task is alive only if that was not done in the
+        # last second for this IOR. Otherwise, a dead task is reported by the
+        # first call made on it (see {TaskContext.invalidate_references}).
+        #
         # @param [String] ior The IOR of the remote task.
         # @param [Hash] options The options.
         # @option options [String] :name Overwrites the real name of remote task
@@ -146,6 +299,34 @@ def ping
             nil
         end
 
+        # The timeout of the CORBA calls made on this task, in milliseconds
+        #
+        # @return [Integer,nil] the timeout set with {#call_timeout=}, or nil
+        #   if the calls use the global timeout (see {CORBA.call_timeout})
+        attr_reader :call_timeout
+
+        # Sets the timeout of the CORBA calls made on this task, in
+        # milliseconds
+        #
+        # It has precedence over both the global timeout and the per-thread
+        # timeouts of {CORBA.with_call_timeout}, and allows e.g. to bound the
+        # latency of the calls to a critical task without shortening the
+        # timeout of long operations on the other tasks.
+        #
+        # The CORBA references are shared between all the TaskContext objects
+        # of the same remote task, so the timeout applies to all of them.
+        #
+        # The timeout is kept if the references to the task get invalidated
+        # and resolved again, e.g. after a communication error.
+        #
+        # @param [Integer,nil] value the timeout. If nil, the per-task timeout
+        #   is removed and the calls use the per-thread or global timeouts
+        #   again
+        def call_timeout=(value)
+            do_call_timeout(value || 0)
+            @call_timeout = value
+        end
+
         # Specialization of the OutputReader to read the task'ss state port. Its
         # read method will return a state in the form of a symbol. For instance, the
         # RUNTIME_ERROR state is returned as :RUNTIME_ERROR
@@ -222,6 +403,37 @@ def tid
             @tid
         end
 
+        # Reads the RTT state of many tasks at once
+        #
+        # The states are read concurrently, which costs roughly a single
+        # round trip instead of one per task
+        #
+        # @param [Array<TaskContext>] tasks
+        # @param [Boolean] raise_on_error if true, a {ParallelCallFailed}
+        #   exception is raised if some states could not be read. Otherwise,
+        #   the corresponding entries of the returned hash are the exceptions
+        # @return [Hash<TaskContext,Symbol>] the state of each task, as
+        #   returned by {#rtt_state}
+        def self.states(tasks, raise_on_error: true)
+            tasks = tasks.to_a
+            values = CORBA.refine_exceptions("tasks") { do_states(tasks) }
+
+            result, errors = Hash.new, Hash.new
+            tasks.each_with_index do |t, i|
+                value = values[i]
+                if value.kind_of?(Exception)
+                    errors[t] = value
+                    result[t] = value
+                else
+                    result[t] = t.state_symbols[value]
+                end
+            end
+            if raise_on_error && !errors.empty?
+                raise ParallelCallFailed.new(errors)
+            end
+            result
+        end
+
         # Reads the state announced by the task's getState() operation
         def rtt_state
             value = CORBA.refine_exceptions(self) { do_state() }
@@ -260,10 +472,70 @@ def create_property_log_stream(p)
         # Tell the task to use the given Pocolog::Logfile object to log all
         # changes to its properties
         def log_all_configuration(logfile)
+            properties = each_property.to_a
             @configuration_log = logfile
-            each_property do |p|
+            values = raw_read_properties(properties)
+            properties.each do |p|
                 create_property_log_stream(p)
-                p.log_current_value
+                p.log_value(Typelib.to_ruby(values[p.name]))
+            end
+        end
+
+        # Writes a set of properties
+        #
+        # The properties that have a setter operation are written first, one
+        # after the other through it. The other ones are written concurrently
+        # afterwards, which costs a single round trip instead of one per
+        # property. All the writes are attempted, even if some of them fail
+        #
+        # @param (see TaskContextBase#raw_write_properties)
+        # @raise (see TaskContextBase#raw_write_properties)
+        def raw_write_properties(values, timestamp = Time.now)
+            properties = values.each_key.map { |name| property(name) }
+            dynamic, direct = properties.partition(&:dynamic?)
+
+            errors = Hash.new
+            dynamic.each do |p|
+                begin
+                    p.write(values[p.name], timestamp)
+                rescue StandardError => e
+                    errors[p.name] = e
+                end
+            end
+
+            direct_values = direct.map do |p|
+                p.ensure_type_available
+                Typelib.from_ruby(values[p.name], p.type)
+            end
+            direct_errors = CORBA.refine_exceptions(self) do
+                do_property_write_all(direct.map(&:name), direct.map(&:type_binding), direct_values)
+            end
+            direct.each_with_index do |p, i|
+                if !direct_errors.has_key?(p.name)
+                    p.log_value(direct_values[i], timestamp)
+                end
+            end
+            errors.merge!(direct_errors)
+
+            if !errors.empty?
+                raise PropertyWriteFailed.new(errors)
+            end
+        end
+
+        # Reads the current value of a set of properties
+        #
+        # All the values are read concurrently, which costs a single round
+        # trip instead of one per property
+        #
+        # @param (see TaskContextBase#raw_read_properties)
+        # @return (see TaskContextBase#raw_read_properties)
+        def raw_read_properties(properties = each_property.to_a)
+            values = properties.map do |p|
+                p.ensure_type_available
+                p.type.new
+            end
+            CORBA.refine_exceptions(self) do
+                do_property_read_all(properties.map(&:name), properties.map(&:type_binding), values)
             end
         end
 
@@ -444,7 +716,10 @@ def attribute(name)
                 end
             end
 
-            type_name = CORBA.refine_exceptions(self) do
+            if (desc = cached_interface_description)
+                type_name = desc.attributes[name]
+            end
+            type_name ||= CORBA.refine_exceptions(self) do
                 begin
                     do_attribute_type_name(name)
                 rescue ArgumentError => e
@@ -462,6 +737,10 @@ def attribute(name)
 
         # Return the property object without caching nor validation
         def raw_property(name)
+            if (desc = cached_interface_description) && (type_name = desc.properties[name])
+                return Property.new(self, name, type_name)
+            end
+
             type_name = CORBA.refine_exceptions(self) do
                 begin
                     do_property_type_name(name)
@@ -511,10 +790,15 @@ def property(name)
         # Resolve a Port object for the given port name
         def raw_port(name)
             port_model = model.find_port(name)
-            do_port(name, port_model)
+            port_desc = port_descriptions[name] ||
+                port_descriptions(refresh: true)[name]
+            if !port_desc
+                raise Orocos::InterfaceObjectNotFound.new(self, name), "task #{self.name} does not have a port named #{name}"
+            end
 
-        rescue Orocos::NotFound => e
-            raise Orocos::InterfaceObjectNotFound.new(self, name), "task #{self.name} does not have a port named #{name}", e.backtrace
+            input, type_name = *port_desc
+            port_class = input ? InputPort : OutputPort
+            port_class.new(self, name, type_name, port_model)
         end
 
         # Returns an object that represents the given port on the remote task
@@ -550,11 +834,16 @@ def port(name, verify = true)
 
         # Returns the names of all the ports defined on this task context
         def port_names
-            CORBA.refine_exceptions(self) do
+            names = CORBA.refine_exceptions(self) do
                 do_port_names.each do |str|
                     str.force_encoding('ASCII') if str.respond_to?(:force_encoding)
                 end
             end
+            # The interface changed, discard the cached port descriptions
+            if (ports = TaskContext.port_descriptions[ior]) && ports.size != names.size
+                TaskContext.port_descriptions.delete(ior)
+            end
+            names
         end
 
         # Returns an Operation object that represents the given method on the
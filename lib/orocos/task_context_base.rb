@@ -55,23 +55,41 @@ def ensure_type_available(options = Hash.new)
             end
         end
 
-        def raw_read
+        # The object that should be passed to #do_read and #do_write to
+        # describe the type of this property/attribute
+        #
+        # It is the orocos type name by default
+        def type_binding
+            @orocos_type_name
+        end
+
+        # Read the current value of the property/attribute as a Typelib value
+        #
+        # @param [Integer,nil] timeout if set, the timeout of the read in
+        #   milliseconds (see {CORBA.with_call_timeout})
+        def raw_read(timeout: nil)
             ensure_type_available
             value = type.new
-            do_read(@orocos_type_name, value)
+            if timeout
+                CORBA.with_call_timeout(timeout) { do_read(type_binding, value) }
+            else
+                do_read(type_binding, value)
+            end
             value
         end
 
         # Read the current value of the property/attribute
-        def read
-            Typelib.to_ruby(raw_read)
+        #
+        # @param (see #raw_read)
+        def read(timeout: nil)
+            Typelib.to_ruby(raw_read(timeout: timeout))
         end
 
         # Sets a new value for the property/attribute
         def write(value, timestamp = Time.now, direct: false)
             ensure_type_available
             value = Typelib.from_ruby(value, type)
-            do_write(@orocos_type_name, value, direct: direct)
+            do_write(type_binding, value, direct: direct)
             log_value(value, timestamp)
             value
         end
@@ -387,6 +405,40 @@ def each_property(&block)
             end
         end
 
+        # Reads the current value of a set of properties
+        #
+        # @param [Array<Property>] properties the properties to read. Defaults
+        #   to all the properties of this task
+        # @return [Hash<String,Typelib::Type>] mapping from the property names
+        #   to their current value
+        def raw_read_properties(properties = each_property.to_a)
+            properties.each_with_object(Hash.new) do |p, result|
+                result[p.name] = p.raw_read
+            end
+        end
+
+        # Writes a set of properties
+        #
+        # All the writes are attempted, even if some of them fail
+        #
+        # @param [Hash<String,Typelib::Type>] values mapping from the property
+        #   names to their new value
+        # @param [Time] timestamp the time used to log the new values
+        # @raise [PropertyWriteFailed] if some of the writes failed
+        def raw_write_properties(values, timestamp = Time.now)
+            errors = Hash.new
+            values.each do |name, value|
+                begin
+                    property(name).write(value, timestamp)
+                rescue StandardError => e
+                    errors[name] = e
+                end
+            end
+            if !errors.empty?
+                raise PropertyWriteFailed.new(errors)
+            end
+        end
+
         # call-seq:
         #  task.each_attribute { |a| ... } => task
         # 
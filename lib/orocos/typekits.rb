@@ -225,6 +225,21 @@ def self.typelib_type_for(t)
         end
     end
 
+    # Returns the object that caches the RTT type information for the given
+    # type
+    #
+    # It is meant to be passed to the native read and write methods instead of
+    # the type name, so that the type does not have to be resolved at each
+    # call
+    #
+    # @param [String] orocos_type_name
+    # @return [TypeBinding]
+    # @raise [ArgumentError] if the type is not registered in the RTT type
+    #   system
+    def self.type_binding_for(orocos_type_name)
+        do_type_binding(orocos_type_name)
+    end
+
     def self.create_or_get_null_type(type_name)
         if registry.include?(type_name)
             type = registry.get type_name
@@ -123,4 +123,24 @@
         assert (Time.now - start_time) < 1
         assert_equal (0...50).to_a, data
     end
+
+    it "emits only the newest sample of each period in coalesce mode" do
+        t1 = Orocos::Async::CORBA::TaskContext.new(source.ior)
+        reader = t1.port("cycle").reader(type: :buffer, size: 100, period: 5, coalesce: true)
+        data = []
+        reader.on_data do |sample|
+            data << sample
+        end
+
+        t1.configure
+        t1.start
+
+        # See "reads buffers in a loop" for the use of the first write
+        source.cycle.write(0)
+        assert_async_polls_until { !data.empty? }
+        49.times { |i| source.cycle.write(i + 1) }
+        assert_async_polls_until { data.last == 49 }
+        assert_equal [0, 49], data
+        assert_equal 48, reader.dropped_sample_count
+    end
 end
@@ -119,6 +119,38 @@
             end
         end
 
+        it "projects subfields that are at a fixed offset" do
+            t1 = Orocos::Async.proxy("simple_source_source",:period => 0.009)
+            Orocos.run('simple_source') do
+                p = t1.port("cycle_struct",:wait => true)
+                projection = p.sub_port(:value).send(:field_projection, p.type)
+                projection.must_be_instance_of Orocos::RubyTasks::FieldProjection
+                assert_equal ['value'], projection.path
+            end
+        end
+
+        it "falls back to the Ruby extraction if the subfield cannot be projected" do
+            t1 = Orocos::Async.proxy("simple_source_source",:period => 0.009)
+            Orocos.run('simple_source') do
+                p = t1.port("cycle_struct",:wait => true)
+                # An index on a struct (TypeError) and a field of a numeric
+                # (ArgumentError)
+                assert_nil p.sub_port(["0"]).send(:field_projection, p.type)
+                assert_nil p.sub_port([:value, :x]).send(:field_projection, p.type)
+            end
+        end
+
+        it "re-computes a failed projection when the sample type changes" do
+            t1 = Orocos::Async.proxy("simple_source_source",:period => 0.009)
+            Orocos.run('simple_source') do
+                p = t1.port("cycle_struct",:wait => true)
+                sub_port = p.sub_port(:value)
+                assert_nil sub_port.send(:field_projection, Orocos.registry.get('/int32_t'))
+                sub_port.send(:field_projection, p.type).
+                    must_be_instance_of Orocos::RubyTasks::FieldProjection
+            end
+        end
+
         it "should call the code block with the sub sample" do
             t1 = Orocos::Async.proxy("simple_source_source",:period => 0.009)
             Orocos.run('simple_source') do
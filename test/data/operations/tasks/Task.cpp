@@ -1,6 +1,7 @@
 /* Generated from orogen/lib/orogen/templates/tasks/Task.cpp */
 
 #include "Task.hpp"
+#include <unistd.h>
 
 using namespace operations;
 
@@ -54,6 +55,11 @@ int Task::simple(::Test::Parameters const& b)
     
 }
 
+void Task::sleep_for(double duration)
+{
+    usleep(duration * 1000000);
+}
+
 
 /// The following lines are template definitions for the various state machine
 // hooks defined by Orocos::RTT. See Task.hpp for more detailed
@@ -30,6 +30,7 @@ namespace operations {
     
 	::Test::Parameters with_returned_parameter(::Test::Parameters& a, ::Test::Opaque const& b);
 	::std::string string_handling(::std::string const& b);
+	void sleep_for(double duration);
     
 
     public:
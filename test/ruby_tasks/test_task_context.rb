@@ -131,5 +131,119 @@
         assert_equal :STOPPED, task.rtt_state
     end
 
+    it "can monitor the state of other tasks through a state multiplexer" do
+        watcher = new_ruby_task_context('watcher')
+        task = new_ruby_task_context('task')
+        multiplexer = watcher.create_state_multiplexer
+        callback_states = []
+        multiplexer.watch(task) { |state, time| callback_states << state }
+        task.configure
+        task.start
+
+        changes = []
+        deadline = Time.now + 2
+        while changes.size < 3 && Time.now < deadline
+            changes.concat multiplexer.wait(0.1)
+        end
+        assert_equal [:PRE_OPERATIONAL, :STOPPED, :RUNNING], changes.map { |_, state, _| state }
+        assert changes.all? { |t, _, time| t == task && time.kind_of?(Time) }
+        assert_equal [:PRE_OPERATIONAL, :STOPPED, :RUNNING], callback_states
+        assert_equal 0, multiplexer.dropped_count
+
+        multiplexer.unwatch(task)
+        refute multiplexer.watching?(task)
+        task.stop
+        assert_equal [], multiplexer.wait(0.1)
+    end
+
+    it "disposes of a state multiplexer without disposing of the caller's task" do
+        watcher = new_ruby_task_context('watcher')
+        multiplexer = watcher.create_state_multiplexer
+        flexmock(watcher).should_receive(:dispose).never
+        multiplexer.dispose
+    end
+
+    it "disposes of the task of a state multiplexer created with StateMultiplexer.new" do
+        multiplexer = Orocos::StateMultiplexer.new
+        flexmock(multiplexer.task).should_receive(:dispose).once.pass_thru
+        multiplexer.dispose
+    end
+
+    it "raises when a state multiplexer is used after its task got disposed" do
+        watcher = new_ruby_task_context('watcher')
+        multiplexer = watcher.create_state_multiplexer
+        watcher.dispose
+        assert_raises(ArgumentError) { multiplexer.do_watch(1, 'state_1') }
+    end
+
+    it "disposes of a flight recorder without disposing of the caller's task" do
+        recorder_task = new_ruby_task_context('recorder')
+        recorder = recorder_task.create_flight_recorder
+        flexmock(recorder_task).should_receive(:dispose).never
+        recorder.dispose
+    end
+
+    it "disposes of the task of a flight recorder created with FlightRecorder.new" do
+        recorder = Orocos::FlightRecorder.new
+        flexmock(recorder.task).should_receive(:dispose).once.pass_thru
+        recorder.dispose
+    end
+
+    it "raises when a flight recorder is used after its task got disposed" do
+        producer = new_ruby_task_context('producer')
+        out = producer.create_output_port 'out', '/double'
+        recorder_task = new_ruby_task_context('recorder')
+        recorder = recorder_task.create_flight_recorder
+        recorder_task.dispose
+        assert_raises(ArgumentError) { recorder.record(out) }
+    end
+
+    it "records the last samples of output ports" do
+        producer = new_ruby_task_context('producer')
+        out = producer.create_output_port 'out', '/double'
+        recorder = new_ruby_task_context('recorder').create_flight_recorder
+        recorder.record(out, capacity: 3)
+        assert recorder.recording?(out)
+
+        5.times { |i| out.write(i) }
+        samples = nil
+        wait_for do
+            samples = recorder.samples(out)
+            !samples.empty? && Typelib.to_ruby(samples.last[1]) == 4
+        end
+        assert_equal [2, 3, 4], samples.map { |_, s| Typelib.to_ruby(s) }
+        samples.each_cons(2) do |(t0, _), (t1, _)|
+            assert(t0 <= t1)
+        end
+        assert_equal [], recorder.samples(out, window: -1)
+
+        recorder.unrecord(out)
+        refute recorder.recording?(out)
+    end
+
+    it "can wait for new data on many input ports at once" do
+        producer = new_ruby_task_context('producer')
+        out0 = producer.create_output_port 'out0', '/double'
+        out1 = producer.create_output_port 'out1', '/double'
+        consumer = new_ruby_task_context('consumer')
+        in0 = consumer.create_input_port 'in0', '/double'
+        in1 = consumer.create_input_port 'in1', '/double'
+        out0.connect_to in0
+        out1.connect_to in1
+
+        group = Orocos::RubyTasks::InputPortGroup.new
+        group.add(in0)
+        group.add(in1)
+        assert_equal [in0, in1], group.wait(0.1).sort_by(&:name)
+        assert_equal [], group.wait(0.1)
+
+        out1.write(10)
+        assert_equal [in1], group.wait(1)
+        assert_equal 10, in1.read_new
+
+        group.remove(in1)
+        out1.write(20)
+        assert_equal [], group.wait(0.1)
+    end
 end
 
@@ -12,6 +12,49 @@
         assert(types.include?("/process/Simple"))
     end
 
+    describe ".parallel" do
+        it "returns the block results in the order of the objects" do
+            assert_equal [2, 4, 6], Orocos::CORBA.parallel([1, 2, 3]) { |i| i * 2 }
+        end
+
+        it "runs all the blocks and reports all the errors" do
+            done = []
+            e = assert_raises(Orocos::ParallelCallFailed) do
+                Orocos::CORBA.parallel([1, 2, 3], max_concurrency: 2) do |i|
+                    done << i
+                    raise ArgumentError, "#{i}" if i != 2
+                end
+            end
+            assert_equal [1, 2, 3], done.sort
+            assert_equal [1, 3], e.errors.keys.sort
+            assert_kind_of ArgumentError, e.errors[1]
+        end
+    end
+
+    describe ".with_call_timeout" do
+        it "sets the timeout of the current thread within the block only" do
+            assert_nil Orocos::CORBA.thread_call_timeout
+            Orocos::CORBA.with_call_timeout(100) do
+                assert_equal 100, Orocos::CORBA.thread_call_timeout
+                Orocos::CORBA.with_call_timeout(50) do
+                    assert_equal 50, Orocos::CORBA.thread_call_timeout
+                end
+                assert_equal 100, Orocos::CORBA.thread_call_timeout
+                assert_nil Thread.new { Orocos::CORBA.thread_call_timeout }.value
+            end
+            assert_nil Orocos::CORBA.thread_call_timeout
+        end
+
+        it "allows to do cancellable state and property reads" do
+            start 'process::Test' => 'test'
+            task = get 'test'
+            Orocos::CORBA.with_call_timeout(1000, cancellable: true) do
+                assert_equal :PRE_OPERATIONAL, task.rtt_state
+                assert_equal 84, task.property('prop2').read
+            end
+        end
+    end
+
     it "should load type registries associated with the plugins" do
         assert_raises(Typelib::NotFound) { Orocos.registry.get("/process/Simple") }
         Orocos.load_typekit 'process'
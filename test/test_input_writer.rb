@@ -50,6 +50,29 @@
         end
     end
 
+    it "should be able to write a batch of samples" do
+        Orocos.run('echo') do |echo|
+            echo  = echo.task('Echo')
+            writer = echo.port('input').writer :type => :buffer, :size => 10
+            reader = echo.port('output').reader :type => :buffer, :size => 10
+
+            echo.start
+            assert_equal(nil, reader.read)
+            assert writer.write_batch([10, 20, 30])
+
+            values = Array.new
+            deadline = Time.now + 2
+            while values.size < 3 && Time.now < deadline
+                if sample = reader.read_new
+                    values << sample
+                else
+                    sleep(0.01)
+                end
+            end
+            assert_equal [10, 20, 30], values
+        end
+    end
+
     it "should be able to write structs using a Hash" do
         Orocos.run('echo') do |echo|
             echo  = echo.task('Echo')
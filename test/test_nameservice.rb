@@ -149,6 +149,64 @@
         end
     end
 
+    describe "#iors" do
+        it "returns the IORs of all the registered tasks" do
+            tasks = (0...3).map { |i| new_ruby_task_context "orocosrb-test#{i}" }
+            iors = name_service.iors(batch_size: 2)
+            tasks.each_with_index do |t, i|
+                assert_equal t.ior, iors["/orocosrb-test#{i}"]
+            end
+            assert_equal name_service.names.sort, iors.keys.sort
+        end
+    end
+
+    describe "#enable_cache" do
+        after do
+            name_service.disable_cache
+        end
+
+        it "reports the tasks that got added and removed" do
+            name_service.enable_cache(ttl: 1, refresh_period: 0.1)
+            assert name_service.cache_enabled?
+            sleep 0.3
+            name_service.cache_changes
+
+            task = new_ruby_task_context 'orocosrb-test'
+            sleep 0.3
+            added, removed = name_service.cache_changes
+            assert_equal ['/orocosrb-test'], added
+            assert_equal [], removed
+            assert_equal task.ior, name_service.ior('orocosrb-test')
+            assert name_service.names.include?('/orocosrb-test')
+
+            task.dispose
+            Orocos::CORBA.name_service.deregister('orocosrb-test')
+            sleep 0.3
+            added, removed = name_service.cache_changes
+            assert_equal [], added
+            assert_equal ['/orocosrb-test'], removed
+        end
+
+        it "raises if the TTL is smaller than the refresh period" do
+            assert_raises(ArgumentError) do
+                name_service.enable_cache(ttl: 0.1, refresh_period: 1)
+            end
+        end
+
+        it "raises if the refresh period is not strictly positive" do
+            assert_raises(ArgumentError) do
+                name_service.enable_cache(ttl: 1, refresh_period: 0)
+            end
+            refute name_service.cache_enabled?
+        end
+
+        it "refreshes the cache with the given batch size and concurrency" do
+            flexmock(name_service).should_receive(:do_enable_cache).
+                with(1, 0.1, 10, 2).once.pass_thru
+            name_service.enable_cache(ttl: 1, refresh_period: 0.1, batch_size: 10, max_concurrency: 2)
+        end
+    end
+
     describe "#ip" do
         it "returns an empty string by default" do
             assert_equal "", name_service.ip
@@ -66,6 +66,53 @@ def find_type(type_name)
         assert_operation_signature ['/Test/Parameters', '/Test/Parameters'], ['/Test/Parameters', '/Test/Opaque'], 'with_returned_parameter'
     end
 
+    it "reuses the same compiled call site across calls" do
+        op = task.operation 'simple'
+        call_site = op.compile
+        assert_kind_of Orocos::OperationCallSite, call_site
+        assert_same call_site, op.compile
+        assert_raises(ArgumentError) { call_site.do_call(nil, []) }
+    end
+
+    it "returns the right result when calling a compiled site with changing arguments" do
+        op = task.operation 'simple'
+        call_site = op.compile
+        arg = find_type('/Test/Parameters').new
+        (0...20).each do |i|
+            arg.set_point = i
+            assert_equal i, op.callop(arg)
+        end
+        assert_same call_site, op.compile
+    end
+
+    it "releases the call site buffer when a compiled call fails" do
+        op = task.operation 'simple'
+        call_site = op.compile
+        assert_raises(TypeError) { call_site.do_call(nil, [42]) }
+
+        arg = find_type('/Test/Parameters').new
+        arg.set_point = 10
+        assert_equal 10, op.callop(arg)
+    end
+
+    it "gives concurrent calls on the same compiled site their own buffer" do
+        op = task.operation 'simple'
+        op.compile
+        parameters_t = find_type('/Test/Parameters')
+        threads = (0...4).map do |t|
+            Thread.new do
+                (0...10).map do |i|
+                    arg = parameters_t.new
+                    arg.set_point = t * 10 + i
+                    [arg.set_point, op.callop(arg)]
+                end
+            end
+        end
+        threads.map(&:value).flatten(1).each do |expected, actual|
+            assert_equal expected, actual
+        end
+    end
+
     it "synchronous call on an empty operation" do
         assert_call_returns nil, 'empty'
     end
@@ -109,6 +156,65 @@ def find_type(type_name)
         assert_call_returns [arg, arg], 'with_returned_parameter', arg, arg
     end
 
+    it "times out a slow synchronous call within with_call_timeout" do
+        op = task.operation('sleep_for')
+        start = Time.now
+        assert_raises(Orocos::CORBA::ComError) do
+            Orocos::CORBA.with_call_timeout(100) { op.callop(2) }
+        end
+        assert (Time.now - start) < 1
+        # The timeout is removed outside of the block
+        op.callop(0.2)
+    end
+
+    it "times out a slow synchronous call on a task with a call timeout" do
+        op = task.operation('sleep_for')
+        task.call_timeout = 100
+        start = Time.now
+        assert_raises(Orocos::CORBA::ComError) { op.callop(2) }
+        assert (Time.now - start) < 1
+        task.call_timeout = nil
+        op.callop(0.2)
+    end
+
+    it "reports completed asynchronous calls through a reactor" do
+        arg = find_type('/Test/Parameters').new
+        arg.set_point = 10
+        reactor = Orocos::SendHandleReactor.new
+        results = []
+        5.times do
+            reactor.watch(task.operation('simple').sendop(arg)) do |status, *values|
+                results << [status, *values]
+            end
+        end
+        deadline = Time.now + 5
+        while reactor.pending_count > 0 && Time.now < deadline
+            reactor.wait(0.1)
+        end
+        assert_equal [[Orocos::SEND_SUCCESS, 10]] * 5,
+            results.map { |status, v| [status, Typelib.to_ruby(v)] }
+    end
+
+    it "notifies the reactor of the calls that complete while it drains" do
+        arg = find_type('/Test/Parameters').new
+        arg.set_point = 10
+        reactor = Orocos::SendHandleReactor.new(period: 0.001)
+        completed = 0
+        50.times do
+            3.times do
+                reactor.watch(task.operation('simple').sendop(arg)) do
+                    completed += 1
+                end
+            end
+            while reactor.pending_count > 0
+                assert IO.select([reactor.io], nil, nil, 2),
+                    "#{reactor.pending_count} calls completed without notification"
+                reactor.process
+            end
+        end
+        assert_equal 150, completed
+    end
+
     it "asynchronous call on an empty operation" do
         assert_send_returns nil, 'empty'
     end
@@ -27,4 +27,15 @@
             end
         end
     end
+
+    describe ".type_binding_for" do
+        it "returns a binding for a type registered in the RTT type system" do
+            assert_kind_of Orocos::TypeBinding, Orocos.type_binding_for('/int32_t')
+        end
+        it "raises ArgumentError if the type is not registered" do
+            assert_raises(ArgumentError) do
+                Orocos.type_binding_for('/does/not/exist')
+            end
+        end
+    end
 end
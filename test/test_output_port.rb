@@ -73,6 +73,49 @@ def dataflow_stress_test_count
                 end
             end
 
+            describe ".connect_all" do
+                attr_reader :other_sink
+                before do
+                    task = new_ruby_task_context 'other_sink'
+                    @other_sink = task.create_input_port 'in', '/double'
+                end
+
+                it "creates all the connections" do
+                    result = Orocos.connect_all([[source, sink], [source, other_sink, type: :buffer, size: 10]])
+                    assert_equal Hash[[source, sink] => true, [source, other_sink] => true], result
+                    assert sink.connected?
+                    assert other_sink.connected?
+                end
+
+                it "reports the connections that failed" do
+                    other_sink.task.dispose
+                    e = assert_raises(ParallelCallFailed) do
+                        Orocos.connect_all([[source, sink], [source, other_sink]])
+                    end
+                    assert_equal [[source, other_sink]], e.errors.keys
+                    assert_kind_of ComError, e.errors[[source, other_sink]]
+                    assert sink.connected?
+                end
+
+                it "optionally removes the created connections if some failed" do
+                    other_sink.task.dispose
+                    result = Orocos.connect_all([[source, sink], [source, other_sink]],
+                                                rollback: true, raise_on_error: false)
+                    assert_equal :rolled_back, result[[source, sink]]
+                    assert_kind_of ComError, result[[source, other_sink]]
+                    refute sink.connected?
+                end
+
+                it "does not remove connections that existed before the call on rollback" do
+                    source.connect_to sink
+                    other_sink.task.dispose
+                    result = Orocos.connect_all([[source, sink], [source, other_sink]],
+                                                rollback: true, raise_on_error: false)
+                    assert_equal true, result[[source, sink]]
+                    assert sink.connected?
+                end
+            end
+
             describe "#disconnect_from" do
                 attr_reader :other_sink
                 before do
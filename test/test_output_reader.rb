@@ -98,6 +98,27 @@
         end
     end
 
+    it "should be able to drain a buffer connection in batches" do
+        Orocos.run('simple_source') do |source|
+            source = source.task('source')
+            output = source.port('cycle')
+            reader = output.reader :type => :buffer, :size => 10
+            source.configure
+            source.start
+            sleep(0.5)
+            source.stop
+
+            first = reader.read_new_batch(3)
+            assert_equal 3, first.size
+            rest = reader.read_new_batch(20)
+            assert(rest.size <= 7)
+            assert_equal [], reader.read_new_batch(20)
+            (first + rest).each_cons(2) do |a, b|
+                assert(b == a + 1, "non-consecutive values #{a.inspect} and #{b.inspect}")
+            end
+        end
+    end
+
     it "should be able to read data from an output port using a struct" do
         Orocos.run('simple_source') do |source|
             source = source.task('source')
@@ -167,6 +188,103 @@
         end
     end
 
+    describe "#wait_new" do
+        attr_reader :task, :reader
+        before do
+            @task = new_ruby_task_context 'test' do
+                output_port 'out', '/double'
+            end
+            @reader = task.out.reader type: :buffer, size: 10
+        end
+
+        it "returns nil if no data arrived before the timeout" do
+            before = Time.now
+            assert_nil reader.wait_new(0.1)
+            assert (Time.now - before) >= 0.1
+        end
+
+        it "returns the sample as soon as it arrives" do
+            writer = Thread.new do
+                sleep 0.1
+                task.out.write(10)
+            end
+            assert_equal 10, reader.wait_new(5)
+            writer.join
+        end
+
+        it "returns the samples that arrived before the call" do
+            task.out.write(10)
+            task.out.write(20)
+            assert_equal 10, reader.wait_new(1)
+            assert_equal 20, reader.wait_new(1)
+            assert_nil reader.wait_new(0.01)
+        end
+    end
+
+    describe "#read_field" do
+        attr_reader :task, :reader, :projection
+        before do
+            @task = new_ruby_task_context 'test' do
+                output_port 'out', '/double'
+            end
+            @reader = task.out.reader
+            @projection = reader.field_projection([])
+        end
+
+        it "returns nil if no sample has been received" do
+            assert_nil reader.read_field(projection)
+        end
+
+        it "returns the last sample's field, even if it has already been read" do
+            task.out.write(10)
+            assert_equal 10, reader.read_field(projection)
+            assert_equal 10, reader.read_field(projection)
+            assert_nil reader.read_new_field(projection)
+        end
+
+        it "raises ArgumentError if the projection is for another type" do
+            other = new_ruby_task_context 'other' do
+                output_port 'out', '/int32_t'
+            end
+            other_projection = other.out.reader.field_projection([])
+            assert_raises(ArgumentError) do
+                reader.read_field(other_projection)
+            end
+        end
+    end
+
+    describe "#read_new_field" do
+        it "reads only the given field of the samples" do
+            Orocos.run('simple_source') do |source|
+                source = source.task('source')
+                reader = source.port('cycle_struct').reader :type => :buffer, :size => 10
+                projection = reader.field_projection(['value'])
+                source.configure
+                source.start
+                sleep(0.5)
+                source.stop
+
+                values = []
+                while v = reader.read_new_field(projection)
+                    values << v
+                end
+                assert(values.size > 1)
+                values.each_cons(2) do |a, b|
+                    assert(b == a + 1, "non-consecutive values #{a.inspect} and #{b.inspect}")
+                end
+            end
+        end
+
+        it "raises ArgumentError if the field does not exist" do
+            Orocos.run('simple_source') do |source|
+                reader = source.task('source').port('cycle_struct').reader
+                assert_raises(ArgumentError) do
+                    reader.field_projection(['does_not_exist'])
+                end
+            end
+        end
+    end
+
     describe "#disconnect" do
         it "disconnects from the port" do
             task = new_ruby_task_context 'test' do
@@ -191,6 +309,32 @@
         end
     end
 
+    describe "opaque types" do
+        it "converts samples concurrently through the type's handle pool" do
+            Orocos.load_typekit 'echo'
+            task = new_ruby_task_context 'test' do
+                output_port 'out', '/OpaquePoint'
+            end
+            reader = task.out.reader :type => :buffer, :size => 100
+            intermediate_t = Orocos.registry.get '/echo/Point'
+
+            threads = (0...4).map do |t|
+                Thread.new do
+                    (0...10).each do |i|
+                        sample = intermediate_t.new
+                        sample.x = t * 10 + i
+                        sample.y = 0
+                        task.out.write sample
+                    end
+                end
+            end
+            threads.each(&:join)
+
+            values = reader.read_new_batch(100).map { |s| Integer(s.x) }
+            assert_equal (0...40).to_a, values.sort
+        end
+    end
+
     if Orocos::SelfTest::USE_MQUEUE
         it "should fallback to CORBA if connection fails with MQ" do
             begin
@@ -1,4 +1,5 @@
 require 'orocos/test'
+require 'tempfile'
 
 describe Orocos::Port do
     include Orocos::Spec
@@ -126,5 +127,101 @@
                 end
             end
         end
+
+        describe "adaptive sizes" do
+            before do
+                flexmock(port).should_receive(:max_marshalling_size).and_return(nil)
+                Orocos::MQueue.adaptive_sizes = true
+            end
+            after do
+                Orocos::MQueue.adaptive_sizes = false
+                Orocos::MQueue.adaptive_warmup = 10
+                Orocos::MQueue.size_profile.clear
+            end
+
+            it "uses the profiled size with the margin if the max marshalling size cannot be computed" do
+                Orocos::MQueue.record_sample_size(port, 100)
+                assert_equal Hash[transport: Orocos::TRANSPORT_MQ, size: 42, data_size: 150],
+                    port.handle_mq_transport("input", transport: 0, size: 42)
+            end
+            it "falls back to the original policy if the port has not been profiled" do
+                assert_equal Hash[transport: 0, size: 42],
+                    port.handle_mq_transport("input", transport: 0, size: 42)
+            end
+            it "validates the profiled size against the system limits" do
+                Orocos::MQueue.record_sample_size(port, 100)
+                flexmock(Orocos::MQueue).should_receive(:valid_sizes?).
+                    with(42, 150, Proc).once.and_return(false)
+                assert_equal Hash[transport: 0, size: 42],
+                    port.handle_mq_transport("input", transport: 0, size: 42)
+            end
+            it "reports that a connection needs profiling only if the size is unknown" do
+                assert port.adaptive_mq_size?(transport: 0)
+                refute port.adaptive_mq_size?(transport: 0, data_size: 10)
+                Orocos::MQueue.record_sample_size(port, 100)
+                refute port.adaptive_mq_size?(transport: 0)
+            end
+            it "switches a reader to MQ with the profiled size once the warmup is finished" do
+                flexmock(Orocos::MQueue).should_receive(:auto?).and_return(true)
+                Orocos::MQueue.adaptive_warmup = 2
+                policies = Array.new
+                flexmock(port).should_receive(:handle_mq_transport).pass_thru do |policy|
+                    policies << policy
+                    policy
+                end
+
+                reader = port.reader(distance: Orocos::PortBase::D_SAME_HOST, type: :buffer, size: 10)
+                assert reader.size_profiling?
+                assert_equal 0, policies.last[:transport]
+                port.write 1
+                port.write 2
+                port.write 3
+                samples = Array.new
+                while sample = reader.read_new
+                    samples << sample
+                end
+                assert_equal [1, 2, 3], samples
+                refute reader.size_profiling?
+                assert_equal Orocos::TRANSPORT_MQ, policies.last[:transport]
+                assert_equal Orocos::MQueue.profiled_size(port), policies.last[:data_size]
+
+                port.write 4
+                deadline = Time.now + 2
+                while !(sample = reader.read_new) && Time.now < deadline
+                    sleep 0.01
+                end
+                assert_equal 4, sample
+            end
+            it "keeps a profiled reader on CORBA if the MQ connection cannot be created" do
+                flexmock(Orocos::MQueue).should_receive(:auto?).and_return(true)
+                flexmock(Orocos::MQueue).should_receive(:auto_fallback_to_corba?).and_return(false)
+                Orocos::MQueue.adaptive_warmup = 1
+                flexmock(port).should_receive(:do_connect_to).
+                    with(FlexMock.any, FlexMock.on { |policy| policy[:transport] == Orocos::TRANSPORT_MQ }).
+                    and_raise(Orocos::ConnectionFailed)
+                flexmock(port).should_receive(:do_connect_to).pass_thru
+
+                reader = port.reader(distance: Orocos::PortBase::D_SAME_HOST)
+                port.write 1
+                assert_equal 1, reader.read_new
+                assert_nil reader.read_new
+                refute reader.size_profiling?
+                port.write 2
+                deadline = Time.now + 2
+                while !(sample = reader.read_new) && Time.now < deadline
+                    sleep 0.01
+                end
+                assert_equal 2, sample
+            end
+            it "saves and loads the size profile" do
+                Orocos::MQueue.record_sample_size(port, 100)
+                Tempfile.open('orocos_size_profile') do |io|
+                    Orocos::MQueue.save_size_profile(io.path)
+                    Orocos::MQueue.size_profile.clear
+                    Orocos::MQueue.load_size_profile(io.path)
+                end
+                assert_equal Hash[port.full_name => 100], Orocos::MQueue.size_profile
+            end
+        end
     end
 end
@@ -21,6 +21,16 @@ module Orocos
                 flexmock(source).should_receive(:process).and_return(nil)
                 assert_equal PortBase::D_UNKNOWN, source.out.distance_to(sink.in)
             end
+            it "returns D_SAME_HOST between the ruby task and a task whose process is on the local host" do
+                flexmock(sink).should_receive(:process).and_return(flexmock(on_localhost?: true))
+                flexmock(Orocos).should_receive(:ruby_task).and_return(source)
+                assert_equal PortBase::D_SAME_HOST, source.out.distance_to(sink.in)
+            end
+            it "returns D_UNKNOWN between the ruby task and a task whose process is remote" do
+                flexmock(sink).should_receive(:process).and_return(flexmock(on_localhost?: false))
+                flexmock(Orocos).should_receive(:ruby_task).and_return(source)
+                assert_equal PortBase::D_UNKNOWN, source.out.distance_to(sink.in)
+            end
             it "returns D_SAME_PROCESS if both tasks have the same process" do
                 process = flexmock
                 flexmock(sink).should_receive(:process).and_return(process)
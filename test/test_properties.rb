@@ -61,6 +61,16 @@
         end
     end
 
+    it "should be able to read all property values at once" do
+        Orocos.run('process') do |process|
+            values = process.task('Test').raw_read_properties
+            assert_equal %w{dynamic_prop dynamic_prop_setter_called prop1 prop2 prop3}, values.keys.sort
+            assert_equal 21, values['prop1'].a
+            assert_equal 84, Typelib.to_ruby(values['prop2'])
+            assert_equal '42', Typelib.to_ruby(values['prop3'])
+        end
+    end
+
     it "should be able to write a property of a simple type" do
         Orocos.run('process') do |process|
             prop = process.task('Test').property('prop2')
@@ -92,6 +102,41 @@
         end
     end
 
+    it "should be able to write a set of properties at once" do
+        start 'process::Test' => 'test'
+        task = get 'test'
+        values = task.raw_read_properties
+        values['prop1'].a = 22
+        values['prop2'] = 42
+        values.delete('dynamic_prop')
+        task.raw_write_properties(values)
+        assert_equal 22, task.prop1.a
+        assert_equal 42, task.prop2
+    end
+
+    it "should write all the properties and report the failures when writing a set of properties" do
+        start 'process::Test' => 'test'
+        task = get 'test'
+        task.configure
+        e = assert_raises(Orocos::PropertyWriteFailed) do
+            task.raw_write_properties('dynamic_prop' => '', 'prop2' => 42)
+        end
+        assert_equal ['dynamic_prop'], e.errors.keys
+        assert_kind_of Orocos::PropertyChangeRejected, e.errors['dynamic_prop']
+        assert_equal 42, task.prop2
+    end
+
+    it "raises the underlying error when applying a configuration fails" do
+        start 'process::Test' => 'test'
+        task = get 'test'
+        task.configure
+        conf = Orocos::TaskConfigurations.new(task.model)
+        assert_raises(Orocos::PropertyChangeRejected) do
+            conf.apply(task, 'dynamic_prop' => '', 'prop2' => 42)
+        end
+        assert_equal 42, task.prop2
+    end
+
     it "should not call the setter operation of a dynamic property if the task is not configured" do
         start 'process::Test' => 'test'
         task = get 'test'
@@ -63,6 +63,43 @@
         end
     end
 
+    it "should describe its whole interface and use the description to resolve ports" do
+        Orocos.run('simple_source') do
+            source = Orocos::TaskContext.get("simple_source_source")
+            desc = source.describe
+            assert_equal %w{cycle cycle_struct out0 out1 out2 out3 state}, desc.ports.keys.sort
+            assert_equal [false, 'int'], desc.ports['cycle']
+            assert desc.operations.include?('configure')
+            assert_same desc, source.describe
+
+            flexmock(source).should_receive(:do_port_descriptions).never
+            port = source.port('cycle')
+            port.must_be_kind_of(Orocos::OutputPort)
+            port.orocos_type_name.must_equal("int")
+        end
+    end
+
+    it "should resolve the port descriptions once per task" do
+        Orocos.run('simple_source') do
+            source = Orocos::TaskContext.get("simple_source_source")
+            Orocos::TaskContext.invalidate_interface_description(source.ior)
+            flexmock(source).should_receive(:do_port_descriptions).once.pass_thru
+            assert_kind_of Orocos::OutputPort, source.raw_port('cycle')
+            assert_kind_of Orocos::OutputPort, source.raw_port('out0')
+            assert_equal [false, 'int'], source.port_descriptions['cycle']
+        end
+    end
+
+    it "should refresh the port descriptions if a port cannot be found in them" do
+        task = new_ruby_task_context 'test'
+        remote = Orocos::TaskContext.new(task.ior)
+        refute remote.port_descriptions.has_key?('out')
+        task.create_output_port 'out', '/double'
+        port = remote.raw_port('out')
+        assert_kind_of Orocos::OutputPort, port
+        assert_equal '/double', port.orocos_type_name
+    end
+
     it "should allow to check an operation availability" do
         Orocos.run('states') do
             t = Orocos::TaskContext.get "states_Task"
@@ -95,6 +132,44 @@
         end
     end
 
+    it "should share the references of the tasks created for the same IOR" do
+        Orocos.run('simple_source') do |p|
+            source = Orocos::TaskContext.get("simple_source_source")
+            other  = Orocos::TaskContext.new(source.ior, model: source.model)
+            assert_equal source, other
+            assert_equal "simple_source_source", other.name
+            other.port("cycle")
+
+            p.kill
+            assert_raises(Orocos::CORBA::ComError) { other.port("cycle") }
+        end
+    end
+
+    it "should allow setting a per-task call timeout" do
+        Orocos.run('simple_source') do
+            source = Orocos::TaskContext.get("simple_source_source")
+            source.call_timeout = 500
+            assert_equal 500, source.call_timeout
+            assert_equal :PRE_OPERATIONAL, source.rtt_state
+            source.call_timeout = nil
+            assert_nil source.call_timeout
+            assert_equal :PRE_OPERATIONAL, source.rtt_state
+        end
+    end
+
+    it "should check that a cached task is still alive before handing it out again" do
+        ior = nil
+        Orocos.run('simple_source') do |p|
+            source = Orocos::TaskContext.get("simple_source_source")
+            ior = source.ior
+            p.kill
+        end
+        sleep 1.1
+        assert_raises(Orocos::CORBA::ComError, Orocos::NotFound) do
+            Orocos::TaskContext.new(ior, name: 'simple_source_source')
+        end
+    end
+
     it "should allow getting an operation object" do
         Orocos.run 'echo' do
             echo = Orocos::TaskContext.get('echo_Echo')
@@ -165,6 +240,29 @@
         end
     end
 
+    it "should read the state of many tasks at once" do
+        Orocos.run('simple_source', 'simple_sink') do
+            source = Orocos::TaskContext.get("simple_source_source")
+            sink   = Orocos::TaskContext.get("simple_sink_sink")
+            source.configure
+            assert_equal Hash[source => :STOPPED, sink => :PRE_OPERATIONAL],
+                Orocos::TaskContext.states([source, sink])
+        end
+    end
+
+    it "should report the tasks whose state cannot be read" do
+        Orocos.run('simple_source') do |p|
+            source = Orocos::TaskContext.get("simple_source_source")
+            p.kill
+            e = assert_raises(Orocos::ParallelCallFailed) do
+                Orocos::TaskContext.states([source])
+            end
+            assert_kind_of Orocos::CORBA::ComError, e.errors[source]
+            states = Orocos::TaskContext.states([source], raise_on_error: false)
+            assert_kind_of Orocos::CORBA::ComError, states[source]
+        end
+    end
+
     it "should raise CORBA::ComError when state-related operations are called on a dead process" do
         Orocos.run('simple_source') do |p|
             source = Orocos::TaskContext.get("simple_source_source")